@@ -0,0 +1,587 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * HTTP load generator for uni.net.bench.http_server.
+ *
+ * Runs on the Linux host and drives the simulated FreeRTOS+TCP stack over the veth/tap link.
+ *  - closed loop: every connection issues the next request as soon as the previous response completed;
+ *  - open loop:   requests are scheduled at a fixed aggregate rate, latency is measured from the scheduled
+ *                 start time so that server stalls are not hidden (no coordinated omission).
+ *
+ * The report is a single JSON object written to stdout or to --output, suitable for regression tracking.
+ */
+
+//
+// Includes
+//
+
+// stdlib
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+// POSIX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+
+
+//
+// Defines
+//
+
+#define UNI_NET_BENCH_LOAD_RX_BUF       (16U * 1024U)
+#define UNI_NET_BENCH_LOAD_STATS_PATH   "/bench/stats.json"
+#define UNI_NET_BENCH_LOAD_IO_TIMEOUT_S (5)
+
+
+
+//
+// Typedefs
+//
+
+typedef enum {
+    UNI_NET_BENCH_LOAD_MODE_CLOSED = 0,
+    UNI_NET_BENCH_LOAD_MODE_OPEN   = 1,
+} uni_net_bench_load_mode_e;
+
+typedef struct {
+    const char* host;
+    uint16_t port;
+    const char* path;
+    uni_net_bench_load_mode_e mode;
+    uint32_t connections;
+    double rate;
+    double duration_s;
+    double warmup_s;
+    const char* output;
+} uni_net_bench_load_config_t;
+
+typedef struct {
+    long heap_free;
+    long heap_min_free;
+    long client_state_bytes;
+    long max_clients;
+    bool valid;
+} uni_net_bench_load_server_stats_t;
+
+typedef struct {
+    const uni_net_bench_load_config_t* cfg;
+    uint32_t index;
+    uint64_t t_start_ns;
+    uint64_t t_measure_ns;
+    uint64_t t_end_ns;
+
+    uint32_t* samples_us;
+    size_t samples_cnt;
+    size_t samples_cap;
+
+    uint64_t requests;
+    uint64_t bytes;
+    uint64_t errors;
+    uint64_t reconnects;
+} uni_net_bench_load_worker_t;
+
+
+
+//
+// Private/Helpers
+//
+
+static uint64_t _now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void _sleep_until_ns(uint64_t deadline_ns) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadline_ns / 1000000000ULL),
+        .tv_nsec = (long)(deadline_ns % 1000000000ULL),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+static bool _samples_push(uni_net_bench_load_worker_t* w, uint32_t value_us) {
+    if (w->samples_cnt == w->samples_cap) {
+        size_t cap = (w->samples_cap == 0U) ? 4096U : w->samples_cap * 2U;
+        uint32_t* p = realloc(w->samples_us, cap * sizeof(*p));
+        if (p == NULL) {
+            return false;
+        }
+        w->samples_us = p;
+        w->samples_cap = cap;
+    }
+    w->samples_us[w->samples_cnt++] = value_us;
+    return true;
+}
+
+static int _cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t _percentile(const uint32_t* sorted, size_t cnt, double p) {
+    if (cnt == 0U) {
+        return 0U;
+    }
+    size_t idx = (size_t)(p * (double)(cnt - 1U) + 0.5);
+    return sorted[idx < cnt ? idx : cnt - 1U];
+}
+
+
+
+//
+// Private/Socket
+//
+
+static int _connect(const uni_net_bench_load_config_t* cfg) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int one = 1;
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    struct timeval tv = { .tv_sec = UNI_NET_BENCH_LOAD_IO_TIMEOUT_S, .tv_usec = 0 };
+    (void)setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    (void)setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(cfg->port);
+    if (inet_pton(AF_INET, cfg->host, &addr.sin_addr) != 1 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool _send_all(int fd, const char* buf, size_t len) {
+    while (len > 0U) {
+        ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * Perform one keep-alive GET and read the full response.
+ * @return body length on success, -1 on I/O error, -2 on non-200 status
+ */
+static long _http_get(int fd, const char* request, size_t request_len, char* buf, size_t buf_size, char* body_out, size_t body_out_size) {
+    if (!_send_all(fd, request, request_len)) {
+        return -1;
+    }
+
+    size_t have = 0U;
+    long hdr_end = -1;
+    while (hdr_end < 0) {
+        if (have == buf_size) {
+            return -1;
+        }
+        ssize_t n = recv(fd, buf + have, buf_size - have, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        have += (size_t)n;
+        for (size_t i = 0; i + 3U < have; i++) {
+            if (memcmp(&buf[i], "\r\n\r\n", 4U) == 0) {
+                hdr_end = (long)(i + 4U);
+                break;
+            }
+        }
+    }
+
+    int status = 0;
+    if (sscanf(buf, "HTTP/1.%*d %d", &status) != 1) {
+        return -1;
+    }
+
+    long content_length = 0;
+    for (char* p = buf; p < buf + hdr_end; p++) {
+        if ((*p == 'C' || *p == 'c') && strncasecmp(p, "Content-Length:", 15U) == 0) {
+            content_length = strtol(p + 15, NULL, 10);
+            break;
+        }
+    }
+
+    size_t body_have = have - (size_t)hdr_end;
+    if (body_out != NULL && body_out_size > 0U) {
+        size_t copy = body_have < body_out_size - 1U ? body_have : body_out_size - 1U;
+        memcpy(body_out, buf + hdr_end, copy);
+        body_out[copy] = '\0';
+    }
+
+    while ((long)body_have < content_length) {
+        size_t want = (size_t)(content_length - (long)body_have);
+        ssize_t n = recv(fd, buf, want < buf_size ? want : buf_size, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (body_out != NULL && body_have < body_out_size - 1U) {
+            size_t copy = (size_t)n < (body_out_size - 1U - body_have) ? (size_t)n : (body_out_size - 1U - body_have);
+            memcpy(body_out + body_have, buf, copy);
+            body_out[body_have + copy] = '\0';
+        }
+        body_have += (size_t)n;
+    }
+
+    return (status == 200) ? content_length : -2;
+}
+
+static size_t _format_request(char* buf, size_t size, const uni_net_bench_load_config_t* cfg, const char* path) {
+    int len = snprintf(buf, size, "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\n\r\n", path, cfg->host);
+    return (len > 0 && (size_t)len < size) ? (size_t)len : 0U;
+}
+
+
+
+//
+// Private/Server stats
+//
+
+static long _json_long(const char* json, const char* key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char* p = strstr(json, pattern);
+    return (p != NULL) ? strtol(p + strlen(pattern), NULL, 10) : -1;
+}
+
+static uni_net_bench_load_server_stats_t _server_stats(const uni_net_bench_load_config_t* cfg) {
+    uni_net_bench_load_server_stats_t result = {0};
+
+    int fd = _connect(cfg);
+    if (fd >= 0) {
+        char request[256];
+        char buf[UNI_NET_BENCH_LOAD_RX_BUF];
+        char body[512];
+        size_t request_len = _format_request(request, sizeof(request), cfg, UNI_NET_BENCH_LOAD_STATS_PATH);
+        if (request_len > 0U && _http_get(fd, request, request_len, buf, sizeof(buf), body, sizeof(body)) > 0) {
+            result.heap_free = _json_long(body, "heap_free");
+            result.heap_min_free = _json_long(body, "heap_min_free");
+            result.client_state_bytes = _json_long(body, "client_state_bytes");
+            result.max_clients = _json_long(body, "max_clients");
+            result.valid = (result.heap_free >= 0) && (result.heap_min_free >= 0);
+        }
+        close(fd);
+    }
+
+    return result;
+}
+
+
+
+//
+// Private/Worker
+//
+
+static void* _worker(void* arg) {
+    uni_net_bench_load_worker_t* w = arg;
+    const uni_net_bench_load_config_t* cfg = w->cfg;
+
+    char request[512];
+    char* buf = malloc(UNI_NET_BENCH_LOAD_RX_BUF);
+    size_t request_len = _format_request(request, sizeof(request), cfg, cfg->path);
+    if (buf == NULL || request_len == 0U) {
+        free(buf);
+        w->errors++;
+        return NULL;
+    }
+
+    // open loop: each connection owns an equal share of the aggregate rate, phase-shifted by its index
+    uint64_t interval_ns = 0U;
+    uint64_t t_next_ns = w->t_start_ns;
+    if (cfg->mode == UNI_NET_BENCH_LOAD_MODE_OPEN) {
+        interval_ns = (uint64_t)(1e9 * (double)cfg->connections / cfg->rate);
+        t_next_ns += (interval_ns * w->index) / cfg->connections;
+    }
+
+    int fd = -1;
+    while (true) {
+        uint64_t t_sched_ns;
+        if (cfg->mode == UNI_NET_BENCH_LOAD_MODE_OPEN) {
+            t_sched_ns = t_next_ns;
+            t_next_ns += interval_ns;
+            if (t_sched_ns >= w->t_end_ns) {
+                break;
+            }
+            _sleep_until_ns(t_sched_ns);
+        } else {
+            t_sched_ns = _now_ns();
+            if (t_sched_ns >= w->t_end_ns) {
+                break;
+            }
+        }
+
+        if (fd < 0) {
+            fd = _connect(cfg);
+            if (fd < 0) {
+                w->errors++;
+                usleep(1000);
+                continue;
+            }
+            w->reconnects++;
+        }
+
+        long body = _http_get(fd, request, request_len, buf, UNI_NET_BENCH_LOAD_RX_BUF, NULL, 0U);
+        uint64_t t_done_ns = _now_ns();
+
+        if (body < 0) {
+            w->errors++;
+            close(fd);
+            fd = -1;
+            continue;
+        }
+
+        if (t_sched_ns >= w->t_measure_ns) {
+            uint64_t latency_us = (t_done_ns - t_sched_ns) / 1000U;
+            if (!_samples_push(w, latency_us > UINT32_MAX ? UINT32_MAX : (uint32_t)latency_us)) {
+                w->errors++;
+            }
+            w->requests++;
+            w->bytes += (uint64_t)body;
+        }
+    }
+
+    if (fd >= 0) {
+        close(fd);
+    }
+    free(buf);
+    return NULL;
+}
+
+
+
+//
+// Private/CLI
+//
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s --host A.B.C.D [--port 80] [--path /bench/small.txt]\n"
+            "          [--mode closed|open] [--connections N] [--rate REQ_PER_S]\n"
+            "          [--duration S] [--warmup S] [--output FILE]\n",
+            argv0);
+}
+
+static bool _parse_args(int argc, char** argv, uni_net_bench_load_config_t* cfg) {
+    for (int i = 1; i < argc; i++) {
+        const char* key = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (val == NULL) {
+            return false;
+        }
+
+        if (strcmp(key, "--host") == 0) {
+            cfg->host = val;
+        } else if (strcmp(key, "--port") == 0) {
+            cfg->port = (uint16_t)strtoul(val, NULL, 10);
+        } else if (strcmp(key, "--path") == 0) {
+            cfg->path = val;
+        } else if (strcmp(key, "--mode") == 0) {
+            if (strcmp(val, "closed") == 0) {
+                cfg->mode = UNI_NET_BENCH_LOAD_MODE_CLOSED;
+            } else if (strcmp(val, "open") == 0) {
+                cfg->mode = UNI_NET_BENCH_LOAD_MODE_OPEN;
+            } else {
+                return false;
+            }
+        } else if (strcmp(key, "--connections") == 0) {
+            cfg->connections = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(key, "--rate") == 0) {
+            cfg->rate = strtod(val, NULL);
+        } else if (strcmp(key, "--duration") == 0) {
+            cfg->duration_s = strtod(val, NULL);
+        } else if (strcmp(key, "--warmup") == 0) {
+            cfg->warmup_s = strtod(val, NULL);
+        } else if (strcmp(key, "--output") == 0) {
+            cfg->output = val;
+        } else {
+            return false;
+        }
+        i++;
+    }
+
+    return cfg->host != NULL && cfg->connections > 0U && cfg->duration_s > 0.0
+        && (cfg->mode == UNI_NET_BENCH_LOAD_MODE_CLOSED || cfg->rate > 0.0);
+}
+
+
+
+//
+// Main
+//
+
+int main(int argc, char** argv) {
+    uni_net_bench_load_config_t cfg = {
+        .host = NULL,
+        .port = 80U,
+        .path = "/bench/small.txt",
+        .mode = UNI_NET_BENCH_LOAD_MODE_CLOSED,
+        .connections = 4U,
+        .rate = 0.0,
+        .duration_s = 10.0,
+        .warmup_s = 1.0,
+        .output = NULL,
+    };
+
+    if (!_parse_args(argc, argv, &cfg)) {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    uni_net_bench_load_server_stats_t stats_before = _server_stats(&cfg);
+
+    uni_net_bench_load_worker_t* workers = calloc(cfg.connections, sizeof(*workers));
+    pthread_t* threads = calloc(cfg.connections, sizeof(*threads));
+    if (workers == NULL || threads == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    uint64_t t_start_ns = _now_ns() + 10000000ULL;
+    uint64_t t_measure_ns = t_start_ns + (uint64_t)(cfg.warmup_s * 1e9);
+    uint64_t t_end_ns = t_measure_ns + (uint64_t)(cfg.duration_s * 1e9);
+
+    uint32_t started = 0U;
+    for (; started < cfg.connections; started++) {
+        workers[started].cfg = &cfg;
+        workers[started].index = started;
+        workers[started].t_start_ns = t_start_ns;
+        workers[started].t_measure_ns = t_measure_ns;
+        workers[started].t_end_ns = t_end_ns;
+        if (pthread_create(&threads[started], NULL, _worker, &workers[started]) != 0) {
+            break;
+        }
+    }
+
+    uint64_t requests = 0U;
+    uint64_t bytes = 0U;
+    uint64_t errors = 0U;
+    uint64_t reconnects = 0U;
+    size_t samples_cnt = 0U;
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        requests += workers[i].requests;
+        bytes += workers[i].bytes;
+        errors += workers[i].errors;
+        reconnects += workers[i].reconnects;
+        samples_cnt += workers[i].samples_cnt;
+    }
+
+    uint32_t* samples = malloc((samples_cnt > 0U ? samples_cnt : 1U) * sizeof(*samples));
+    if (samples == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    size_t off = 0U;
+    uint64_t latency_sum_us = 0U;
+    for (uint32_t i = 0; i < started; i++) {
+        memcpy(&samples[off], workers[i].samples_us, workers[i].samples_cnt * sizeof(*samples));
+        off += workers[i].samples_cnt;
+        free(workers[i].samples_us);
+    }
+    for (size_t i = 0; i < samples_cnt; i++) {
+        latency_sum_us += samples[i];
+    }
+    qsort(samples, samples_cnt, sizeof(*samples), _cmp_u32);
+
+    uni_net_bench_load_server_stats_t stats_after = _server_stats(&cfg);
+
+    long heap_high_water = -1;
+    long heap_per_connection = -1;
+    if (stats_before.valid && stats_after.valid) {
+        heap_high_water = stats_before.heap_free - stats_after.heap_min_free;
+        heap_per_connection = heap_high_water / (long)cfg.connections;
+    }
+
+    FILE* out = stdout;
+    if (cfg.output != NULL) {
+        out = fopen(cfg.output, "w");
+        if (out == NULL) {
+            fprintf(stderr, "cannot open %s: %s\n", cfg.output, strerror(errno));
+            return 1;
+        }
+    }
+
+    fprintf(out,
+            "{\n"
+            "  \"bench\": \"uni_net_http_server\",\n"
+            "  \"mode\": \"%s\",\n"
+            "  \"path\": \"%s\",\n"
+            "  \"connections\": %" PRIu32 ",\n"
+            "  \"target_rate_rps\": %.1f,\n"
+            "  \"duration_s\": %.3f,\n"
+            "  \"requests\": %" PRIu64 ",\n"
+            "  \"errors\": %" PRIu64 ",\n"
+            "  \"connects\": %" PRIu64 ",\n"
+            "  \"throughput_rps\": %.1f,\n"
+            "  \"throughput_bytes_per_s\": %.1f,\n"
+            "  \"latency_us\": {\"min\": %" PRIu32 ", \"mean\": %.1f, \"p50\": %" PRIu32 ", \"p90\": %" PRIu32
+            ", \"p99\": %" PRIu32 ", \"p999\": %" PRIu32 ", \"max\": %" PRIu32 "},\n"
+            "  \"server\": {\"stats_valid\": %s, \"heap_free_before\": %ld, \"heap_min_free_after\": %ld"
+            ", \"heap_high_water_bytes\": %ld, \"heap_per_connection_bytes\": %ld"
+            ", \"client_state_bytes\": %ld, \"max_clients\": %ld}\n"
+            "}\n",
+            cfg.mode == UNI_NET_BENCH_LOAD_MODE_OPEN ? "open" : "closed",
+            cfg.path,
+            cfg.connections,
+            cfg.rate,
+            cfg.duration_s,
+            requests,
+            errors,
+            reconnects,
+            (double)requests / cfg.duration_s,
+            (double)bytes / cfg.duration_s,
+            samples_cnt > 0U ? samples[0] : 0U,
+            samples_cnt > 0U ? (double)latency_sum_us / (double)samples_cnt : 0.0,
+            _percentile(samples, samples_cnt, 0.50),
+            _percentile(samples, samples_cnt, 0.90),
+            _percentile(samples, samples_cnt, 0.99),
+            _percentile(samples, samples_cnt, 0.999),
+            samples_cnt > 0U ? samples[samples_cnt - 1U] : 0U,
+            (stats_before.valid && stats_after.valid) ? "true" : "false",
+            stats_before.heap_free,
+            stats_after.heap_min_free,
+            heap_high_water,
+            heap_per_connection,
+            stats_after.client_state_bytes,
+            stats_after.max_clients);
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    free(samples);
+    free(workers);
+    free(threads);
+    return (errors > 0U && requests == 0U) ? 1 : 0;
+}
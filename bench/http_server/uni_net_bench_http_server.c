@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: MIT
+
+/*
+ * HTTP server benchmark target for the FreeRTOS+TCP PC/Linux port.
+ *
+ * Starts uni_net_http_server on a static IPv4 end-point bound to the pcap interface selected by
+ * configNETWORK_INTERFACE_TO_USE (use one side of a veth pair or a bridged tap). The server exposes:
+ *  - /bench/small.txt  : UNI_NET_BENCH_HTTP_SMALL_SIZE bytes static file
+ *  - /bench/large.bin  : UNI_NET_BENCH_HTTP_LARGE_SIZE bytes static file
+ *  - /bench/stats.json : heap and per-connection memory counters, consumed by uni.net.bench.http_load
+ */
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdio.h>
+#include <string.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <task.h>
+
+// FreeRTOS+TCP
+#include <FreeRTOS_IP.h>
+#include <FreeRTOS_Routing.h>
+
+// Uni.Common
+#include <uni_common.h>
+
+// Uni.Net
+#include "uni_net.h"
+
+
+
+//
+// Defines
+//
+
+#ifndef UNI_NET_BENCH_HTTP_MAX_CLIENTS
+#define UNI_NET_BENCH_HTTP_MAX_CLIENTS (16U)
+#endif
+
+#ifndef UNI_NET_BENCH_HTTP_SMALL_SIZE
+#define UNI_NET_BENCH_HTTP_SMALL_SIZE  (512U)
+#endif
+
+#ifndef UNI_NET_BENCH_HTTP_LARGE_SIZE
+#define UNI_NET_BENCH_HTTP_LARGE_SIZE  (64U * 1024U)
+#endif
+
+#ifndef UNI_NET_BENCH_HTTP_IP
+#define UNI_NET_BENCH_HTTP_IP          { 10, 0, 77, 2 }
+#endif
+
+#ifndef UNI_NET_BENCH_HTTP_MASK
+#define UNI_NET_BENCH_HTTP_MASK        { 255, 255, 255, 0 }
+#endif
+
+#ifndef UNI_NET_BENCH_HTTP_GW
+#define UNI_NET_BENCH_HTTP_GW          { 10, 0, 77, 1 }
+#endif
+
+#ifndef UNI_NET_BENCH_HTTP_MAC
+#define UNI_NET_BENCH_HTTP_MAC         { 0x02, 0x00, 0x4E, 0x45, 0x54, 0x01 }
+#endif
+
+
+
+//
+// Externals
+//
+
+// Provided by src_driver/linux/NetworkInterface.c, no public header
+extern NetworkInterface_t* pxLinux_FillInterfaceDescriptor(BaseType_t xEMACIndex, NetworkInterface_t* pxInterface);
+
+
+
+//
+// Globals
+//
+
+static NetworkInterface_t g_bench_iface;
+static NetworkEndPoint_t g_bench_endpoint;
+
+static uni_net_http_server_context_t g_bench_http;
+
+static uint8_t g_bench_small[UNI_NET_BENCH_HTTP_SMALL_SIZE];
+static uint8_t g_bench_large[UNI_NET_BENCH_HTTP_LARGE_SIZE];
+
+
+
+//
+// Private/Handlers
+//
+
+static size_t _uni_net_bench_http_stats(void* userdata, uint8_t* buf_out, size_t buf_out_size, const uint8_t* buf_in, size_t buf_in_len) {
+    (void)userdata;
+    (void)buf_in;
+    (void)buf_in_len;
+
+    int len = snprintf((char*)buf_out, buf_out_size,
+                       "{\"heap_free\":%lu,\"heap_min_free\":%lu,\"client_state_bytes\":%lu,\"max_clients\":%lu}",
+                       (unsigned long)xPortGetFreeHeapSize(),
+                       (unsigned long)xPortGetMinimumEverFreeHeapSize(),
+                       (unsigned long)sizeof(uni_net_http_server_client_state_t),
+                       (unsigned long)g_bench_http.config.max_clients);
+
+    return (len > 0) ? uni_common_math_min((size_t)len, buf_out_size) : 0U;
+}
+
+
+
+//
+// Private/Init
+//
+
+static void _uni_net_bench_http_fill_payload(uint8_t* buf, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        buf[i] = (uint8_t)('a' + (i % 26U));
+    }
+}
+
+static bool _uni_net_bench_http_init(void) {
+    bool result = false;
+
+    _uni_net_bench_http_fill_payload(g_bench_small, sizeof(g_bench_small));
+    _uni_net_bench_http_fill_payload(g_bench_large, sizeof(g_bench_large));
+
+    memset(&g_bench_http, 0, sizeof(g_bench_http));
+    g_bench_http.config.max_clients = UNI_NET_BENCH_HTTP_MAX_CLIENTS;
+
+    if (uni_common_array_init(&g_bench_http.config.files, sizeof(uni_net_http_file_t), 2U)
+     && uni_common_array_init(&g_bench_http.config.handlers, sizeof(uni_net_http_handler_t), 1U)) {
+        result = uni_net_http_server_register_file_ex(&g_bench_http, "/bench/small.txt", g_bench_small, sizeof(g_bench_small))
+              && uni_net_http_server_register_file_ex(&g_bench_http, "/bench/large.bin", g_bench_large, sizeof(g_bench_large))
+              && uni_net_http_server_register_handler_ex(&g_bench_http, UNI_NET_HTTP_COMMAND_GET, "/bench/stats.json", _uni_net_bench_http_stats, NULL)
+              && uni_net_http_server_init(&g_bench_http);
+    }
+
+    return result;
+}
+
+
+
+//
+// FreeRTOS+TCP hooks
+//
+
+void vApplicationIPNetworkEventHook_Multi(eIPCallbackEvent_t eNetworkEvent, struct xNetworkEndPoint* pxEndPoint) {
+    (void)pxEndPoint;
+    if (eNetworkEvent == eNetworkUp) {
+        printf("uni.net.bench.http_server: network up\n");
+    }
+}
+
+eDHCPCallbackAnswer_t xApplicationDHCPHook_Multi(eDHCPCallbackPhase_t eDHCPPhase, struct xNetworkEndPoint* pxEndPoint, IP_Address_t* pxIPAddress) {
+    (void)eDHCPPhase;
+    (void)pxEndPoint;
+    (void)pxIPAddress;
+    return eDHCPUseDefaults;
+}
+
+const char* pcApplicationHostnameHook(void) {
+    return "uni-net-bench";
+}
+
+void vApplicationPingReplyHook(ePingReplyStatus_t eStatus, uint16_t usIdentifier) {
+    (void)eStatus;
+    (void)usIdentifier;
+}
+
+BaseType_t xApplicationGetRandomNumber(uint32_t* pulNumber) {
+    static uint32_t state = 0x2545F491U;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    *pulNumber = state;
+    return pdTRUE;
+}
+
+uint32_t ulApplicationGetNextSequenceNumber(uint32_t ulSourceAddress, uint16_t usSourcePort, uint32_t ulDestinationAddress, uint16_t usDestinationPort) {
+    (void)ulSourceAddress;
+    (void)usSourcePort;
+    (void)ulDestinationAddress;
+    (void)usDestinationPort;
+
+    uint32_t result = 0U;
+    (void)xApplicationGetRandomNumber(&result);
+    return result;
+}
+
+
+
+//
+// Main
+//
+
+int main(void) {
+    static const uint8_t ip[ipIP_ADDRESS_LENGTH_BYTES] = UNI_NET_BENCH_HTTP_IP;
+    static const uint8_t mask[ipIP_ADDRESS_LENGTH_BYTES] = UNI_NET_BENCH_HTTP_MASK;
+    static const uint8_t gw[ipIP_ADDRESS_LENGTH_BYTES] = UNI_NET_BENCH_HTTP_GW;
+    static const uint8_t mac[ipMAC_ADDRESS_LENGTH_BYTES] = UNI_NET_BENCH_HTTP_MAC;
+
+    (void)pxLinux_FillInterfaceDescriptor(0, &g_bench_iface);
+    FreeRTOS_FillEndPoint(&g_bench_iface, &g_bench_endpoint, ip, mask, gw, gw, mac);
+    g_bench_endpoint.bits.bWantDHCP = pdFALSE_UNSIGNED;
+
+    if (FreeRTOS_IPInit_Multi() != pdPASS || !_uni_net_bench_http_init()) {
+        printf("uni.net.bench.http_server: init failed\n");
+        return 1;
+    }
+
+    printf("uni.net.bench.http_server: listening on %u.%u.%u.%u:80\n", ip[0], ip[1], ip[2], ip[3]);
+    vTaskStartScheduler();
+    return 0;
+}
@@ -8,6 +8,9 @@ extern "C" {
 #include "uni_net_http_server.h"
 #include "uni_net_udp_client.h"
 #include "uni_net_udp_server.h"
+#include "uni_net_udp_coalesce.h"
+#include "uni_net_udp_rpc.h"
+#include "uni_net_udp_segment.h"
 
 #if defined(__cplusplus)
 }
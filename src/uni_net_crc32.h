@@ -0,0 +1,52 @@
+#pragma once
+
+/*
+ * CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320) for incremental integrity checks of transfers,
+ * compatible with zlib crc32(). Uses the ARMv8 CRC32 instructions when the target provides them,
+ * slice-by-8 tables otherwise (8 KiB of constant data in flash).
+ */
+
+//
+// Includes
+//
+
+// stdlib
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+//
+// Defines
+//
+
+/**
+ * Table driven fallback processes 8 bytes per step, set to 0 for the 1 KiB byte-wise table
+ */
+#ifndef UNI_NET_CRC32_SLICE_BY_8
+#define UNI_NET_CRC32_SLICE_BY_8 (1)
+#endif
+
+
+
+//
+// Functions
+//
+
+/**
+ * Continue a CRC over the next chunk
+ * @param crc CRC of the preceding data, 0 to start
+ * @param data chunk data
+ * @param size chunk size in bytes
+ * @return CRC of the preceding data and the chunk
+ */
+uint32_t uni_net_crc32_update(uint32_t crc, const void *data, size_t size);
+
+/**
+ * CRC of two concatenated blocks from the CRCs of the blocks
+ * @param crc1 CRC of the first block
+ * @param crc2 CRC of the second block
+ * @param size2 size of the second block in bytes
+ * @return CRC of the first block followed by the second
+ */
+uint32_t uni_net_crc32_combine(uint32_t crc1, uint32_t crc2, uint64_t size2);
@@ -3,18 +3,21 @@
 //
 
 // stdlib
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 // FreeRTOS
 #include <FreeRTOS_IP.h>
+#include <semphr.h>
 
 // Uni.Common
 #include <uni_common.h>
 
 // ox
 #include "uni_net_ftp_client.h"
+#include "uni_net_crc32.h"
 
 #include "io/uni_hal_io_stdio.h"
 
@@ -40,25 +43,53 @@
 //
 
 typedef enum {
+    UNI_NET_FTP_CODE_125_DATA_CONN_OPEN = 125,
     UNI_NET_FTP_CODE_150_OPENING_DATA_CONN = 150,
     UNI_NET_FTP_CODE_200_OK = 200,
     UNI_NET_FTP_CODE_202_NO_MEANING = 202,
+    UNI_NET_FTP_CODE_213_FILE_STATUS = 213,
     UNI_NET_FTP_CODE_220_SERVICE_READY = 220,
     UNI_NET_FTP_CODE_226_TRANSFER_COMPLETE = 226,
     UNI_NET_FTP_CODE_227_ENTERING_PASSIVE_MODE = 227,
     UNI_NET_FTP_CODE_230_LOGIN_OK = 230,
+    UNI_NET_FTP_CODE_250_FILE_ACTION_OK = 250,
     UNI_NET_FTP_CODE_257_PATHNAME = 257,
     UNI_NET_FTP_CODE_331_PASSWORD_REQUIRED = 331,
+    UNI_NET_FTP_CODE_350_PENDING_FURTHER_INFO = 350,
     UNI_NET_FTP_CODE_421_SERVICE_NOT_AVAILABLE = 421,
     UNI_NET_FTP_CODE_425_FAILED_TO_OPEN_CONN = 425,
     UNI_NET_FTP_CODE_426_ERROR_WRITING_NETWORK_STREAM = 426,
     UNI_NET_FTP_CODE_451_SOCKET_ERROR = 451,
+    UNI_NET_FTP_CODE_452_INSUFFICIENT_STORAGE = 452,
     UNI_NET_FTP_CODE_500_SERVICE_ERROR = 500,
     UNI_NET_FTP_CODE_501_NEED_PARAMETER = 501,
+    UNI_NET_FTP_CODE_502_NOT_IMPLEMENTED = 502,
     UNI_NET_FTP_CODE_530_NOT_LOGGED_IN = 530,
     UNI_NET_FTP_CODE_550_FILE_UNAVAILABLE = 550,
+    UNI_NET_FTP_CODE_553_NAME_NOT_ALLOWED = 553,
 } uni_net_ftp_code_e;
 
+/**
+ * One connection of a parallel retrieval
+ */
+typedef struct {
+    uni_net_ftp_client_context_t ctx;
+    struct uni_net_ftp_client_parallel_s *owner;
+    SemaphoreHandle_t exited;
+    bool started;
+    volatile uint32_t received;
+    uint32_t crc32;
+    volatile bool finished;
+    volatile bool failed;
+} uni_net_ftp_client_lane_t;
+
+struct uni_net_ftp_client_parallel_s {
+    uni_net_ftp_client_context_t *parent;
+    SemaphoreHandle_t lock;
+    uint32_t count;
+    uni_net_ftp_client_lane_t lanes[UNI_NET_FTP_CLIENT_PARALLEL_MAX];
+};
+
 
 //
 // Globals
@@ -94,12 +125,40 @@ static bool _uni_net_ftp_client_list_files(uni_net_ftp_client_context_t *ctx) {
     return _uni_net_ftp_client_send_cmd(ctx, "LIST\r\n");
 }
 
+static bool _uni_net_ftp_client_list_dir(uni_net_ftp_client_context_t *ctx, const char *cmd, const char *path) {
+    char data[64] = {};
+    if (path[0] != '\0') {
+        uni_hal_io_stdio_snprintf(data, sizeof(data), "%s %s\r\n", cmd, path);
+    } else {
+        uni_hal_io_stdio_snprintf(data, sizeof(data), "%s\r\n", cmd);
+    }
+    return _uni_net_ftp_client_send_cmd(ctx, data);
+}
+
+static bool _uni_net_ftp_client_size_file(uni_net_ftp_client_context_t *ctx, const char *file) {
+    char data[64] = {};
+    uni_hal_io_stdio_snprintf(data, sizeof(data), "SIZE %s\r\n", file);
+    return _uni_net_ftp_client_send_cmd(ctx, data);
+}
+
+static bool _uni_net_ftp_client_rest(uni_net_ftp_client_context_t *ctx, uint32_t offset) {
+    char data[24] = {};
+    uni_hal_io_stdio_snprintf(data, sizeof(data), "REST %lu\r\n", (unsigned long)offset);
+    return _uni_net_ftp_client_send_cmd(ctx, data);
+}
+
 static bool _uni_net_ftp_client_retr_file(uni_net_ftp_client_context_t *ctx, const char *file) {
     char data[64] = {};
     uni_hal_io_stdio_snprintf(data, sizeof(data), "RETR %s\r\n", file);
     return _uni_net_ftp_client_send_cmd(ctx, data);
 }
 
+static bool _uni_net_ftp_client_stor_file(uni_net_ftp_client_context_t *ctx, const char *file, bool append) {
+    char data[64] = {};
+    uni_hal_io_stdio_snprintf(data, sizeof(data), "%s %s\r\n", append ? "APPE" : "STOR", file);
+    return _uni_net_ftp_client_send_cmd(ctx, data);
+}
+
 static bool _uni_net_ftp_client_send_login(uni_net_ftp_client_context_t *ctx) {
     char data[64] = {};
     uni_hal_io_stdio_snprintf(data, sizeof(data), "USER %s\r\n", ctx->config.auth_user);
@@ -124,9 +183,196 @@ static void _uni_net_ftp_client_set_to_idle(uni_net_ftp_client_context_t *ctx) {
     ctx->state.task.cookie_file = NULL;
     ctx->state.task.progress = 0;
     ctx->state.task.progress_total = 0;
+    ctx->state.task.offset = 0;
+    ctx->state.task.ranged = false;
+    ctx->state.task.sized = false;
+    ctx->state.task.open_ended = false;
+    ctx->state.data_eof = false;
+    ctx->state.data_confirmed = false;
+    ctx->state.task.parts = 0;
+    ctx->state.task.source = NULL;
+    ctx->state.task.crc32 = 0;
     ctx->state.task.name[0] = '\0';
 }
 
+static bool _uni_net_ftp_client_is_upload(const uni_net_ftp_client_task_t *task) {
+    return task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_STOR || task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_APPE;
+}
+
+/**
+ * Task runs over a data connection of this client opened with PASV
+ */
+static bool _uni_net_ftp_client_uses_pasv(const uni_net_ftp_client_task_t *task) {
+    return task->type != UNI_NET_FTP_CLIENT_TASK_TYPE_RETR_PARALLEL && task->type != UNI_NET_FTP_CLIENT_TASK_TYPE_MLST;
+}
+
+static void _uni_net_ftp_client_list_entry(void *cookie, const uni_net_ftp_list_entry_t *entry) {
+    uni_net_ftp_client_context_t *ctx = cookie;
+    if (ctx->state.callback) {
+        ctx->state.callback(ctx->state.cookie, &ctx->state.task, UNI_NET_FTP_CLIENT_CALLBACK_ENTRY, (void *)entry, sizeof(*entry));
+    }
+}
+
+/**
+ * Report the end of a transfer task
+ */
+static void _uni_net_ftp_client_report(uni_net_ftp_client_context_t *ctx, const uni_net_ftp_client_task_t *task, bool success) {
+    if (ctx->state.callback) {
+        uni_net_ftp_client_callback_type_e type;
+        if (_uni_net_ftp_client_is_upload(task)) {
+            type = success ? UNI_NET_FTP_CLIENT_CALLBACK_SEND_FINISHED : UNI_NET_FTP_CLIENT_CALLBACK_SEND_FAILED;
+        } else {
+            type = success ? UNI_NET_FTP_CLIENT_CALLBACK_RECV_FINISHED : UNI_NET_FTP_CLIENT_CALLBACK_RECV_FAILED;
+        }
+
+        // a finished download carries its digest
+        if (success && ctx->config.digest == UNI_NET_FTP_CLIENT_DIGEST_CRC32
+            && (task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR || task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR_PARALLEL)) {
+            ctx->state.callback(ctx->state.cookie, task, type, (void *)&task->crc32, sizeof(task->crc32));
+        } else {
+            ctx->state.callback(ctx->state.cookie, task, type, NULL, 0);
+        }
+    }
+}
+
+static bool _uni_net_ftp_client_queue_push(uni_net_ftp_client_context_t *ctx, const uni_net_ftp_client_task_t *task) {
+    bool result = false;
+
+    taskENTER_CRITICAL();
+    if (ctx->state.queue_count < UNI_NET_FTP_CLIENT_QUEUE_SIZE) {
+        uint32_t idx = (ctx->state.queue_head + ctx->state.queue_count) % UNI_NET_FTP_CLIENT_QUEUE_SIZE;
+        ctx->state.queue[idx] = *task;
+        ctx->state.queue_count++;
+        result = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+static bool _uni_net_ftp_client_queue_push_front(uni_net_ftp_client_context_t *ctx, const uni_net_ftp_client_task_t *task) {
+    bool result = false;
+
+    taskENTER_CRITICAL();
+    if (ctx->state.queue_count < UNI_NET_FTP_CLIENT_QUEUE_SIZE) {
+        ctx->state.queue_head = (ctx->state.queue_head + UNI_NET_FTP_CLIENT_QUEUE_SIZE - 1U) % UNI_NET_FTP_CLIENT_QUEUE_SIZE;
+        ctx->state.queue[ctx->state.queue_head] = *task;
+        ctx->state.queue_count++;
+        result = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+static bool _uni_net_ftp_client_queue_pop(uni_net_ftp_client_context_t *ctx, uni_net_ftp_client_task_t *task) {
+    bool result = false;
+
+    taskENTER_CRITICAL();
+    if (ctx->state.queue_count > 0U) {
+        *task = ctx->state.queue[ctx->state.queue_head];
+        ctx->state.queue_head = (ctx->state.queue_head + 1U) % UNI_NET_FTP_CLIENT_QUEUE_SIZE;
+        ctx->state.queue_count--;
+        result = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+/**
+ * Make the first queued task current. Its data connection is reused when the pipelined PASV already
+ * completed, or picked up by the 227 handler when the reply is still pending.
+ */
+static bool _uni_net_ftp_client_queue_next(uni_net_ftp_client_context_t *ctx) {
+    bool result = _uni_net_ftp_client_queue_pop(ctx, &ctx->state.task);
+
+    if (result) {
+        if (!_uni_net_ftp_client_uses_pasv(&ctx->state.task)) {
+            // no PASV is pipelined for a parallel retrieval (connections of its own) or MLST (control connection only)
+            ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED;
+        } else if (ctx->state.socket_data_next != NULL) {
+            ctx->state.socket_data = ctx->state.socket_data_next;
+            ctx->state.socket_data_next = NULL;
+            ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_STARTED;
+        } else if (ctx->state.pasv_next_requested) {
+            ctx->state.pasv_next_requested = false;
+            ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_SWITCH_TO_PASV;
+        } else {
+            ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED;
+        }
+    }
+
+    return result;
+}
+
+static void _uni_net_ftp_client_queue_fail(uni_net_ftp_client_context_t *ctx) {
+    uni_net_ftp_client_task_t task;
+    while (_uni_net_ftp_client_queue_pop(ctx, &task)) {
+        _uni_net_ftp_client_report(ctx, &task, false);
+    }
+}
+
+
+//
+// Functions/Autotuning
+//
+
+/**
+ * Bound a RX window to the configured memory, the RX buffer is twice the window
+ * @return window in bytes, a multiple of the MSS
+ */
+static uint32_t _uni_net_ftp_client_tune_clamp(const uni_net_ftp_client_context_t *ctx, uint64_t win) {
+    uint64_t buf = win * 2U;
+    if (buf < ctx->config.data_rx_buf_min) {
+        buf = ctx->config.data_rx_buf_min;
+    }
+    if (buf > ctx->config.data_rx_buf_max) {
+        buf = ctx->config.data_rx_buf_max;
+    }
+    uint32_t segments = (uint32_t)(buf / 2U / ipconfigTCP_MSS);
+    return (segments > 0U ? segments : 1U) * ipconfigTCP_MSS;
+}
+
+static uint32_t _uni_net_ftp_client_tune_window(const uni_net_ftp_client_context_t *ctx) {
+    return ctx->state.data_rx_win > 0U ? ctx->state.data_rx_win : _uni_net_ftp_client_tune_clamp(ctx, 10U * ipconfigTCP_MSS);
+}
+
+/**
+ * Account a data connection handshake as RTT sample
+ */
+static void _uni_net_ftp_client_tune_rtt(uni_net_ftp_client_context_t *ctx, TickType_t ticks) {
+    uint32_t sample = uni_common_math_max((uint32_t)(ticks * portTICK_PERIOD_MS), 1U);
+    ctx->state.data_rtt_ms = ctx->state.data_rtt_ms > 0U ? (ctx->state.data_rtt_ms * 7U + sample) / 8U : sample;
+}
+
+/**
+ * Size the RX window of the next data socket from the delivery rate of the finished download
+ */
+static void _uni_net_ftp_client_tune_sample(uni_net_ftp_client_context_t *ctx) {
+    if (ctx->config.data_rx_buf_max == 0U || ctx->state.data_rtt_ms == 0U) {
+        return;
+    }
+
+    const uint32_t win = _uni_net_ftp_client_tune_window(ctx);
+    const uint32_t bytes = ctx->state.task.progress;
+    const uint32_t elapsed_ms = (uint32_t)((xTaskGetTickCount() - ctx->state.data_start) * portTICK_PERIOD_MS);
+
+    // a transfer shorter than one window ends in slow start and tells nothing about the link
+    if (elapsed_ms == 0U || bytes < win) {
+        return;
+    }
+
+    uint64_t bdp = (uint64_t)bytes * ctx->state.data_rtt_ms / elapsed_ms;
+    if (bdp * 4U >= (uint64_t)win * 3U) {
+        // the window limited the rate, probe a larger one
+        ctx->state.data_rx_win = _uni_net_ftp_client_tune_clamp(ctx, (uint64_t)win * 2U);
+    } else {
+        // keep twice the BDP as headroom for rate variation
+        ctx->state.data_rx_win = _uni_net_ftp_client_tune_clamp(ctx, bdp * 2U);
+    }
+}
+
 
 //
 // Functions/Connection
@@ -144,13 +390,19 @@ static bool _uni_net_ftp_client_connect_socket(uni_net_ftp_client_context_t *ctx
     *socket = FreeRTOS_socket(FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP);
 
     if (*socket) {
-        // set RX socket window for data port
+        // set socket window for data port
         if (port != ctx->config.server_port) {
+            const WinProperties_t *win = &ctx->config.data_window;
             WinProperties_t xWinProperties = {0};
-            xWinProperties.lRxBufSize = 20 * ipconfigTCP_MSS; /* Units of bytes. */
-            xWinProperties.lRxWinSize = 10; /* Size in units of MSS */
-            xWinProperties.lTxBufSize = 4 * ipconfigTCP_MSS; /* Units of bytes. */
-            xWinProperties.lTxWinSize = 2; /* Size in units of MSS */
+            xWinProperties.lRxBufSize = win->lRxBufSize > 0 ? win->lRxBufSize : (int32_t)(20 * ipconfigTCP_MSS); /* Units of bytes. */
+            xWinProperties.lRxWinSize = win->lRxWinSize > 0 ? win->lRxWinSize : 10; /* Size in units of MSS */
+            xWinProperties.lTxBufSize = win->lTxBufSize > 0 ? win->lTxBufSize : (int32_t)(4 * ipconfigTCP_MSS); /* Units of bytes. */
+            xWinProperties.lTxWinSize = win->lTxWinSize > 0 ? win->lTxWinSize : 2; /* Size in units of MSS */
+            if (ctx->config.data_rx_buf_max > 0U) {
+                uint32_t rx_win = _uni_net_ftp_client_tune_window(ctx);
+                xWinProperties.lRxBufSize = (int32_t)(rx_win * 2U);
+                xWinProperties.lRxWinSize = (int32_t)(rx_win / ipconfigTCP_MSS);
+            }
             FreeRTOS_setsockopt(*socket, 0, FREERTOS_SO_WIN_PROPERTIES, (void *) &xWinProperties,
                                 sizeof(xWinProperties));
         }
@@ -174,9 +426,14 @@ static bool _uni_net_ftp_client_connect_socket(uni_net_ftp_client_context_t *ctx
             FreeRTOS_setsockopt(*socket, 0, FREERTOS_SO_SNDTIMEO, &timeout_tx, sizeof(timeout_tx));
         }
 
+        TickType_t connect_start = xTaskGetTickCount();
         BaseType_t connect_result = FreeRTOS_connect(*socket, &sockaddr, sizeof(sockaddr));
         if (connect_result == 0) {
             result = true;
+            // the handshake of a data connection is the RTT sample of the autotuning
+            if (port != ctx->config.server_port) {
+                _uni_net_ftp_client_tune_rtt(ctx, xTaskGetTickCount() - connect_start);
+            }
             FreeRTOS_FD_SET(*socket, ctx->state.socket_set, eSELECT_READ);
         } else {
             UNI_NET_FTP_CLIENT_DBG_1("_uni_net_ftp_client_connect_socket -> failed to connect socket, errno=%d",
@@ -196,10 +453,20 @@ static void _uni_net_ftp_client_disconnect(uni_net_ftp_client_context_t *ctx, bo
         ctx->state.socket_data = NULL;
     }
 
+    if (ctx->state.socket_data_next != NULL) {
+        FreeRTOS_closesocket(ctx->state.socket_data_next);
+        ctx->state.socket_data_next = NULL;
+    }
+    ctx->state.pasv_next_requested = false;
+    ctx->state.size_pending = false;
+
     if (ctx->state.socket_cmd != NULL) {
         FreeRTOS_closesocket(ctx->state.socket_cmd);
         ctx->state.socket_cmd = NULL;
     }
+    ctx->state.cmd_len = 0;
+    ctx->state.cmd_multiline = 0;
+    ctx->state.cmd_skip = false;
 
     if (ctx->state.socket_set != NULL) {
         FreeRTOS_DeleteSocketSet(ctx->state.socket_set);
@@ -213,18 +480,223 @@ static void _uni_net_ftp_client_disconnect(uni_net_ftp_client_context_t *ctx, bo
     ctx->state.task.type = UNI_NET_FTP_CLIENT_TASK_TYPE_TERMINATION;
 }
 
+//
+// Functions/Parallel
+//
+
+static void _uni_net_ftp_client_parallel_callback(void *cookie, const uni_net_ftp_client_task_t *task,
+                                                  uni_net_ftp_client_callback_type_e type, void *data, size_t data_size) {
+    uni_net_ftp_client_lane_t *lane = cookie;
+    uni_net_ftp_client_context_t *parent = lane->owner->parent;
+
+    switch (type) {
+        case UNI_NET_FTP_CLIENT_CALLBACK_RECV: {
+            // the sink sees one range at a time
+            xSemaphoreTake(lane->owner->lock, portMAX_DELAY);
+            if (parent->state.callback) {
+                parent->state.callback(parent->state.cookie, task, type, data, data_size);
+            }
+            xSemaphoreGive(lane->owner->lock);
+            lane->received += data_size;
+            break;
+        }
+        case UNI_NET_FTP_CLIENT_CALLBACK_RECV_FINISHED: {
+            lane->crc32 = task->crc32;
+            lane->finished = true;
+            break;
+        }
+        default: {
+            // the server may drop the connection after the range was cut short, that is not a failure
+            if (!lane->finished) {
+                lane->failed = true;
+            }
+            break;
+        }
+    }
+}
+
+static void _uni_net_ftp_client_parallel_stop(uni_net_ftp_client_context_t *ctx) {
+    struct uni_net_ftp_client_parallel_s *parallel = ctx->state.parallel;
+    if (parallel == NULL) {
+        return;
+    }
+
+    // request all lanes to stop first, then join them one by one
+    for (uint32_t i = 0; i < parallel->count; i++) {
+        uni_net_ftp_client_disconnect(&parallel->lanes[i].ctx);
+    }
+    for (uint32_t i = 0; i < parallel->count; i++) {
+        uni_net_ftp_client_lane_t *lane = &parallel->lanes[i];
+        if (lane->started) {
+            xSemaphoreTake(lane->exited, portMAX_DELAY);
+        }
+        if (lane->exited != NULL) {
+            vSemaphoreDelete(lane->exited);
+        }
+    }
+
+    vSemaphoreDelete(parallel->lock);
+    vPortFree(parallel);
+    ctx->state.parallel = NULL;
+}
+
+/**
+ * Number of ranges the file of the current task is cut into
+ */
+static uint32_t _uni_net_ftp_client_parallel_count(const uni_net_ftp_client_context_t *ctx) {
+    return uni_common_math_min(ctx->state.task.parts, ctx->state.task.progress_total / UNI_NET_FTP_CLIENT_PARALLEL_MIN_RANGE);
+}
+
+/**
+ * Retrieve the file of the current task with a single RETR over this connection
+ * @param size file size, 0 if the server did not tell
+ */
+static void _uni_net_ftp_client_parallel_single(uni_net_ftp_client_context_t *ctx, uint32_t size) {
+    ctx->state.task.type = UNI_NET_FTP_CLIENT_TASK_TYPE_RETR;
+    ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED;
+    ctx->state.task.progress = 0;
+    ctx->state.task.progress_total = size;
+    ctx->state.task.offset = 0;
+    ctx->state.task.ranged = false;
+    ctx->state.task.open_ended = (size == 0U);
+    ctx->state.task.parts = 0;
+}
+
+static bool _uni_net_ftp_client_parallel_start(uni_net_ftp_client_context_t *ctx) {
+    const uint32_t size = ctx->state.task.progress_total;
+    const uint32_t count = _uni_net_ftp_client_parallel_count(ctx);
+
+    struct uni_net_ftp_client_parallel_s *parallel = pvPortCalloc(1, sizeof(*parallel));
+    if (parallel == NULL) {
+        return false;
+    }
+    parallel->lock = xSemaphoreCreateMutex();
+    if (parallel->lock == NULL) {
+        vPortFree(parallel);
+        return false;
+    }
+    parallel->parent = ctx;
+    ctx->state.parallel = parallel;
+
+    bool result = true;
+    const uint32_t range = size / count;
+    for (uint32_t i = 0; i < count && result; i++) {
+        uni_net_ftp_client_lane_t *lane = &parallel->lanes[i];
+        lane->owner = parallel;
+        lane->ctx.config = ctx->config;
+        lane->ctx.state.data_rtt_ms = ctx->state.data_rtt_ms;
+        lane->ctx.state.data_rx_win = ctx->state.data_rx_win;
+        uni_net_ftp_client_set_callback(&lane->ctx, _uni_net_ftp_client_parallel_callback, lane);
+
+        // the last range takes the remainder
+        uni_net_ftp_client_task_t task = {
+            .type = UNI_NET_FTP_CLIENT_TASK_TYPE_RETR,
+            .state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED,
+            .cookie_file = ctx->state.task.cookie_file,
+            .progress = 0,
+            .progress_total = (i + 1U == count) ? (size - i * range) : range,
+            .offset = i * range,
+            .ranged = true,
+        };
+        memcpy(task.name, ctx->state.task.name, sizeof(task.name));
+
+        // the lane thread gives the semaphore on exit, _uni_net_ftp_client_parallel_stop() joins on it
+        lane->exited = xSemaphoreCreateBinary();
+        lane->ctx.state.exited = lane->exited;
+        result = lane->exited != NULL && _uni_net_ftp_client_queue_push(&lane->ctx, &task);
+        if (result) {
+            lane->started = uni_net_ftp_client_connect(&lane->ctx, 0U, 0U);
+            result = lane->started;
+        }
+        parallel->count = i + 1U;
+    }
+
+    return result;
+}
+
+static void _uni_net_ftp_client_work_state_parallel(uni_net_ftp_client_context_t *ctx) {
+    switch (ctx->state.task.state) {
+        case UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED: {
+            ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_REQUESTED;
+            _uni_net_ftp_client_size_file(ctx, ctx->state.task.name);
+            break;
+        }
+        case UNI_NET_FTP_CLIENT_TASK_STATE_STARTED: {
+            // size is known
+            if (ctx->state.task.progress_total == 0U) {
+                ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED;
+            } else if (_uni_net_ftp_client_parallel_count(ctx) < 2U) {
+                // a single range does not pay for a connection of its own
+                _uni_net_ftp_client_parallel_single(ctx, ctx->state.task.progress_total);
+            } else if (_uni_net_ftp_client_parallel_start(ctx)) {
+                ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS;
+            } else {
+                ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FAILED;
+            }
+            break;
+        }
+        case UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS: {
+            // before the SIZE reply there are no lanes yet
+            struct uni_net_ftp_client_parallel_s *parallel = ctx->state.parallel;
+            if (parallel != NULL) {
+                bool finished = true;
+                bool failed = false;
+                uint32_t progress = 0;
+                for (uint32_t i = 0; i < parallel->count; i++) {
+                    progress += parallel->lanes[i].received;
+                    finished = finished && parallel->lanes[i].finished;
+                    failed = failed || parallel->lanes[i].failed;
+                }
+                ctx->state.task.progress = progress;
+
+                if (failed) {
+                    ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FAILED;
+                } else if (finished) {
+                    ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED;
+                }
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    if (ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED || ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_FAILED) {
+        // the file CRC is joined from the CRCs of the ranges in file order
+        struct uni_net_ftp_client_parallel_s *parallel = ctx->state.parallel;
+        if (ctx->config.digest == UNI_NET_FTP_CLIENT_DIGEST_CRC32 && ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED
+            && parallel != NULL && parallel->count > 0U) {
+            uint32_t crc = parallel->lanes[0].crc32;
+            for (uint32_t i = 1; i < parallel->count; i++) {
+                crc = uni_net_crc32_combine(crc, parallel->lanes[i].crc32, parallel->lanes[i].received);
+            }
+            ctx->state.task.crc32 = crc;
+        }
+
+        _uni_net_ftp_client_parallel_stop(ctx);
+        _uni_net_ftp_client_report(ctx, &ctx->state.task, ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED);
+        _uni_net_ftp_client_set_to_idle(ctx);
+    }
+}
+
+
 //
 // Functions/Handlers
 //
 static void _uni_net_ftp_client_handler_150(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_20x(uni_net_ftp_client_context_t *ctx, const char *str);
+static void _uni_net_ftp_client_handler_213(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_220(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_226(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_227(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_230(uni_net_ftp_client_context_t *ctx, const char *str);
+static void _uni_net_ftp_client_handler_250(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_257(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_331(uni_net_ftp_client_context_t *ctx, const char *str);
+static void _uni_net_ftp_client_handler_350(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_error(uni_net_ftp_client_context_t *ctx, const char *str);
+static void _uni_net_ftp_client_handler_50x(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_530(uni_net_ftp_client_context_t *ctx, const char *str);
 static void _uni_net_ftp_client_handler_550(uni_net_ftp_client_context_t *ctx, const char *str);
 
@@ -234,11 +706,20 @@ static void _uni_net_ftp_client_handler_550(uni_net_ftp_client_context_t *ctx, c
  */
 static void _uni_net_ftp_client_handler_150(uni_net_ftp_client_context_t *ctx, const char *str) {
     if (str != NULL) {
+        // a ranged retrieval keeps the requested length, an upload the size given by the user,
+        // a parsed listing and an open-ended retrieval end with their data connection
+        if (ctx->state.task.ranged || ctx->state.task.sized || ctx->state.task.open_ended || _uni_net_ftp_client_is_upload(&ctx->state.task)
+            || ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD) {
+            return;
+        }
+
         //determine file size
         str = strchr(str, '(');
         if (str != NULL) {
             str++;
-            ctx->state.task.progress_total = strtol(str, NULL, 10);
+            uint32_t size = strtoul(str, NULL, 10);
+            // without a SIZE reply a resumed retrieval takes the announcement as the full file size
+            ctx->state.task.progress_total = (size > ctx->state.task.offset) ? size - ctx->state.task.offset : size;
         }
         else {
             ctx->state.task.progress_total = 1;
@@ -259,6 +740,26 @@ static void _uni_net_ftp_client_handler_20x(uni_net_ftp_client_context_t *ctx, c
 }
 
 
+/**
+ * 213: File Status, reply to SIZE
+ * @param ctx
+ */
+static void _uni_net_ftp_client_handler_213(uni_net_ftp_client_context_t *ctx, const char *str) {
+    if (ctx->state.size_pending) {
+        // full size of the file of a resumed retrieval
+        ctx->state.size_pending = false;
+        if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR && ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_REQUESTED) {
+            uint32_t size = strtoul(str, NULL, 10);
+            ctx->state.task.progress_total = (size > ctx->state.task.offset) ? size - ctx->state.task.offset : 0U;
+            ctx->state.task.sized = true;
+        }
+    } else if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR_PARALLEL && ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_REQUESTED) {
+        ctx->state.task.progress_total = strtoul(str, NULL, 10);
+        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_STARTED;
+    }
+}
+
+
 /**
  * 220: service ready for new user
  * @param ctx
@@ -278,8 +779,22 @@ static void _uni_net_ftp_client_handler_220(uni_net_ftp_client_context_t *ctx, c
  * @param ctx
  */
 static void _uni_net_ftp_client_handler_226(uni_net_ftp_client_context_t *ctx, const char *str) {
-    (void) ctx;
     (void) str;
+    // an upload is complete once the server stored all data
+    if (_uni_net_ftp_client_is_upload(&ctx->state.task) && ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED) {
+        _uni_net_ftp_client_report(ctx, &ctx->state.task, true);
+        _uni_net_ftp_client_set_to_idle(ctx);
+    } else if (ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS) {
+        if (ctx->state.task.open_ended) {
+            ctx->state.data_confirmed = true;
+        }
+        // the server is done with this transfer while its data still drains here: open the data connection
+        // of the next task now. Sent earlier, during the transfer, servers reject the PASV with 425/503.
+        if (ctx->state.queue_count > 0U && !ctx->state.pasv_next_requested && ctx->state.socket_data_next == NULL
+            && _uni_net_ftp_client_uses_pasv(&ctx->state.queue[ctx->state.queue_head])) {
+            ctx->state.pasv_next_requested = _uni_net_ftp_client_switch_to_passive(ctx);
+        }
+    }
 }
 
 
@@ -317,12 +832,21 @@ static void _uni_net_ftp_client_handler_227(uni_net_ftp_client_context_t *ctx, c
 
             if (parse_ok) {
                 uint16_t port = (data[4] << 8) + data[5];
-                result = _uni_net_ftp_client_connect_socket(ctx, &ctx->state.socket_data, port);
+                if (ctx->state.pasv_next_requested) {
+                    // reply to the PASV pipelined for the first queued task
+                    result = _uni_net_ftp_client_connect_socket(ctx, &ctx->state.socket_data_next, port);
+                } else {
+                    result = _uni_net_ftp_client_connect_socket(ctx, &ctx->state.socket_data, port);
+                }
             } else {
                 result = false;
             }
         }
-        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_STARTED;
+        if (ctx->state.pasv_next_requested) {
+            ctx->state.pasv_next_requested = false;
+        } else {
+            ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_STARTED;
+        }
     }
 
     if (!result) {
@@ -341,6 +865,18 @@ static void _uni_net_ftp_client_handler_230(uni_net_ftp_client_context_t *ctx, c
 }
 
 
+/**
+ * 250: Requested file action okay, closing line of the MLST reply
+ * @param ctx
+ */
+static void _uni_net_ftp_client_handler_250(uni_net_ftp_client_context_t *ctx, const char *str) {
+    (void)str;
+    if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLST) {
+        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED;
+    }
+}
+
+
 /**
  * 257: Pathname Created
  * @param ctx
@@ -361,11 +897,49 @@ static void _uni_net_ftp_client_handler_331(uni_net_ftp_client_context_t *ctx, c
 }
 
 
+/**
+ * 350: Requested file action pending further information, reply to REST
+ * @param ctx
+ */
+static void _uni_net_ftp_client_handler_350(uni_net_ftp_client_context_t *ctx, const char *str) {
+    // RETR is sent right behind REST
+    (void) ctx;
+    (void) str;
+}
+
+
 static void _uni_net_ftp_client_handler_error(uni_net_ftp_client_context_t *ctx, const char *str) {
     (void)str;
     _uni_net_ftp_client_disconnect(ctx, true, UNI_NET_FTP_CLIENT_DISCONNECT_REASON_RESPONSE_ERR);
 }
 
+/**
+ * 500/502: command not recognized or not implemented
+ * @param ctx
+ */
+static void _uni_net_ftp_client_handler_50x(uni_net_ftp_client_context_t *ctx, const char *str) {
+    if (ctx->state.size_pending) {
+        // SIZE is optional, the size announced with RETR is used instead
+        ctx->state.size_pending = false;
+    } else if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD && !ctx->state.mlsd_unsupported) {
+        // server without RFC 3659, repeat the listing with LIST over a new data connection
+        ctx->state.mlsd_unsupported = true;
+        if (ctx->state.socket_data != NULL) {
+            FreeRTOS_closesocket(ctx->state.socket_data);
+            ctx->state.socket_data = NULL;
+        }
+        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED;
+    } else if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLST) {
+        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FAILED;
+    } else if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR_PARALLEL
+               && ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_REQUESTED) {
+        // server without SIZE, the ranges cannot be cut: retrieve the file in one piece
+        _uni_net_ftp_client_parallel_single(ctx, 0U);
+    } else {
+        _uni_net_ftp_client_handler_error(ctx, str);
+    }
+}
+
 /**
  * 530: not logged in
  * @param ctx
@@ -382,7 +956,12 @@ static void _uni_net_ftp_client_handler_530(uni_net_ftp_client_context_t *ctx, c
  */
 static void _uni_net_ftp_client_handler_550(uni_net_ftp_client_context_t *ctx, const char *str) {
     (void)str;
-    ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FAILED;
+    if (ctx->state.size_pending) {
+        // reply to SIZE, a missing file fails with the reply to RETR
+        ctx->state.size_pending = false;
+    } else {
+        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FAILED;
+    }
 }
 
 
@@ -398,23 +977,30 @@ typedef struct {
 } uni_net_ftp_client_cmd_map_t;
 
 static const uni_net_ftp_client_cmd_map_t _uni_net_ftp_client_cmd_map[] = {
+    { UNI_NET_FTP_CODE_125_DATA_CONN_OPEN, _uni_net_ftp_client_handler_150 },
     { UNI_NET_FTP_CODE_150_OPENING_DATA_CONN, _uni_net_ftp_client_handler_150 },
     { UNI_NET_FTP_CODE_200_OK, _uni_net_ftp_client_handler_20x },
     { UNI_NET_FTP_CODE_202_NO_MEANING, _uni_net_ftp_client_handler_20x },
+    { UNI_NET_FTP_CODE_213_FILE_STATUS, _uni_net_ftp_client_handler_213 },
     { UNI_NET_FTP_CODE_220_SERVICE_READY, _uni_net_ftp_client_handler_220 },
     { UNI_NET_FTP_CODE_226_TRANSFER_COMPLETE, _uni_net_ftp_client_handler_226 },
     { UNI_NET_FTP_CODE_227_ENTERING_PASSIVE_MODE, _uni_net_ftp_client_handler_227},
     { UNI_NET_FTP_CODE_230_LOGIN_OK, _uni_net_ftp_client_handler_230 },
+    { UNI_NET_FTP_CODE_250_FILE_ACTION_OK, _uni_net_ftp_client_handler_250 },
     { UNI_NET_FTP_CODE_257_PATHNAME, _uni_net_ftp_client_handler_257},
     { UNI_NET_FTP_CODE_331_PASSWORD_REQUIRED, _uni_net_ftp_client_handler_331},
+    { UNI_NET_FTP_CODE_350_PENDING_FURTHER_INFO, _uni_net_ftp_client_handler_350},
     { UNI_NET_FTP_CODE_421_SERVICE_NOT_AVAILABLE, _uni_net_ftp_client_handler_error},
     { UNI_NET_FTP_CODE_425_FAILED_TO_OPEN_CONN, _uni_net_ftp_client_handler_error},
     { UNI_NET_FTP_CODE_426_ERROR_WRITING_NETWORK_STREAM, _uni_net_ftp_client_handler_error },
     { UNI_NET_FTP_CODE_451_SOCKET_ERROR, _uni_net_ftp_client_handler_error},
-    { UNI_NET_FTP_CODE_500_SERVICE_ERROR, _uni_net_ftp_client_handler_error},
+    { UNI_NET_FTP_CODE_452_INSUFFICIENT_STORAGE, _uni_net_ftp_client_handler_550},
+    { UNI_NET_FTP_CODE_500_SERVICE_ERROR, _uni_net_ftp_client_handler_50x},
     { UNI_NET_FTP_CODE_501_NEED_PARAMETER, _uni_net_ftp_client_handler_error},
+    { UNI_NET_FTP_CODE_502_NOT_IMPLEMENTED, _uni_net_ftp_client_handler_50x},
     { UNI_NET_FTP_CODE_530_NOT_LOGGED_IN, _uni_net_ftp_client_handler_530},
     { UNI_NET_FTP_CODE_550_FILE_UNAVAILABLE, _uni_net_ftp_client_handler_550},
+    { UNI_NET_FTP_CODE_553_NAME_NOT_ALLOWED, _uni_net_ftp_client_handler_550},
 };
 
 static void _uni_net_ftp_client_work_cmd_single(uni_net_ftp_client_context_t *ctx, char *buf) {
@@ -440,48 +1026,152 @@ static void _uni_net_ftp_client_work_cmd_single(uni_net_ftp_client_context_t *ct
     _uni_net_ftp_client_disconnect(ctx, true, UNI_NET_FTP_CLIENT_DISCONNECT_REASON_WRONG_CMD);
 }
 
-static void _uni_net_ftp_client_work_cmd(uni_net_ftp_client_context_t *ctx) {
-    // retrieve amount of available data
-    int byte_count = FreeRTOS_recvcount(ctx->state.socket_cmd);
-    if (byte_count > 0) {
-        // get received data
-        // TODO: zerocopy
-        char *buf = pvPortCalloc(byte_count + 1, 1);
-        if(buf == NULL) {
-            _uni_net_ftp_client_disconnect(ctx, true, UNI_NET_FTP_CLIENT_DISCONNECT_REASON_MEMORY_ALLOC);
-            return;
+/**
+ * Handle one reply line. Lines of a multi-line reply ("xyz-") are consumed until the closing "xyz " line,
+ * which is dispatched alone.
+ */
+static void _uni_net_ftp_client_work_cmd_line(uni_net_ftp_client_context_t *ctx, char *line) {
+    bool coded = isdigit((unsigned char)line[0]) && isdigit((unsigned char)line[1]) && isdigit((unsigned char)line[2])
+              && (line[3] == ' ' || line[3] == '-');
+
+    if (ctx->state.cmd_multiline != 0U) {
+        if (coded && line[3] == ' ' && (uint32_t)atoi(line) == ctx->state.cmd_multiline) {
+            ctx->state.cmd_multiline = 0;
+            _uni_net_ftp_client_work_cmd_single(ctx, line);
+        } else if (line[0] == ' ' && ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLST
+                   && ctx->state.cmd_multiline == UNI_NET_FTP_CODE_250_FILE_ACTION_OK) {
+            // the MLST entry is the space indented line of the 250 reply
+            uni_net_ftp_list_entry_t entry;
+            if (uni_net_ftp_list_parse_mlsx(&line[1], &entry)) {
+                _uni_net_ftp_client_list_entry(ctx, &entry);
+            }
         }
-        int byte_rcv = FreeRTOS_recv(ctx->state.socket_cmd, buf, byte_count, 0);
-        if (byte_rcv > 0) {
-            char *next_line;
-            for (char *line = buf; line != NULL; line = next_line) {
-                next_line = strstr(line, "\r\n");
-                if (next_line) {
-                    *next_line = '\0';
-                    next_line += 2;
-                }
-                if (*line) {
-                    _uni_net_ftp_client_work_cmd_single(ctx, line);
-                }
+    } else if (coded && line[3] == '-') {
+        ctx->state.cmd_multiline = (uint32_t)atoi(line);
+    } else if (*line) {
+        _uni_net_ftp_client_work_cmd_single(ctx, line);
+    }
+}
 
-                if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_TERMINATION) {
-                    break;
-                }
-            }
+/**
+ * Split the line buffer into lines, parsed in place. An unterminated tail stays for the next read.
+ */
+static void _uni_net_ftp_client_work_cmd_lines(uni_net_ftp_client_context_t *ctx) {
+    char *line = ctx->state.cmd_buf;
+    char *end = &ctx->state.cmd_buf[ctx->state.cmd_len];
+
+    while (line < end && ctx->state.task.type != UNI_NET_FTP_CLIENT_TASK_TYPE_TERMINATION) {
+        char *lf = memchr(line, '\n', (size_t)(end - line));
+        if (lf == NULL) {
+            break;
         }
 
-        // clear memory
-        vPortFree(buf);
+        char *eol = (lf > line && lf[-1] == '\r') ? &lf[-1] : lf;
+        *eol = '\0';
+        if (!ctx->state.cmd_skip) {
+            _uni_net_ftp_client_work_cmd_line(ctx, line);
+        }
+        ctx->state.cmd_skip = false;
+        line = lf + 1;
+    }
 
+    size_t rest = (size_t)(end - line);
+    if (rest == sizeof(ctx->state.cmd_buf) - 1U) {
+        // no line end in a full buffer: handle the truncated line, drop the remainder
+        ctx->state.cmd_buf[rest] = '\0';
+        if (!ctx->state.cmd_skip) {
+            _uni_net_ftp_client_work_cmd_line(ctx, line);
+        }
+        ctx->state.cmd_skip = true;
+        rest = 0;
+    }
+    memmove(ctx->state.cmd_buf, line, rest);
+    ctx->state.cmd_len = rest;
+}
+
+static bool _uni_net_ftp_client_work_cmd(uni_net_ftp_client_context_t *ctx) {
+    bool result = true;
+
+    // read straight into the line buffer, one byte stays free for the terminator
+    while (ctx->state.task.type != UNI_NET_FTP_CLIENT_TASK_TYPE_TERMINATION) {
+        int32_t byte_rcv = FreeRTOS_recv(ctx->state.socket_cmd, &ctx->state.cmd_buf[ctx->state.cmd_len],
+                                         sizeof(ctx->state.cmd_buf) - 1U - ctx->state.cmd_len, FREERTOS_MSG_DONTWAIT);
         if (byte_rcv <= 0) {
-            _uni_net_ftp_client_disconnect(ctx, true, UNI_NET_FTP_CLIENT_DISCONNECT_REASON_NO_BYTES);
+            // connection lost, the thread decides about reconnecting
+            result = byte_rcv == 0 || byte_rcv == -pdFREERTOS_ERRNO_EWOULDBLOCK;
+            break;
         }
+
+        ctx->state.cmd_len += (uint32_t)byte_rcv;
+        _uni_net_ftp_client_work_cmd_lines(ctx);
     }
+
+    return result;
 }
 
 
+/**
+ * Fill the TX stream of the data socket from the upload source, without an intermediate copy
+ * @param ctx
+ */
+static void _uni_net_ftp_client_work_upload(uni_net_ftp_client_context_t *ctx) {
+    uni_net_ftp_client_task_t *task = &ctx->state.task;
+
+    while (task->state == UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS) {
+        BaseType_t space = 0;
+        uint8_t *head = FreeRTOS_get_tx_head(ctx->state.socket_data, &space);
+        if (head == NULL || space <= 0) {
+            break;
+        }
+
+        int32_t len = task->source(task->cookie_file, head, (size_t)space);
+        if (len < 0) {
+            task->state = UNI_NET_FTP_CLIENT_TASK_STATE_FAILED;
+        } else if (len == 0) {
+            // FIN marks the end of the file, completion is confirmed with 226
+            FreeRTOS_FD_CLR(ctx->state.socket_data, ctx->state.socket_set, eSELECT_ALL);
+            FreeRTOS_shutdown(ctx->state.socket_data, FREERTOS_SHUT_RDWR);
+            task->state = UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED;
+        } else {
+            // pvBuffer NULL commits the bytes written at the stream head
+            len = FreeRTOS_send(ctx->state.socket_data, NULL, uni_common_math_min(len, space), FREERTOS_MSG_DONTWAIT);
+            if (len <= 0) {
+                break;
+            }
+            task->progress += (uint32_t)len;
+            if (ctx->state.callback) {
+                ctx->state.callback(ctx->state.cookie, task, UNI_NET_FTP_CLIENT_CALLBACK_SEND, head, (size_t)len);
+            }
+        }
+    }
+}
+
 static void _uni_net_ftp_client_work_data(uni_net_ftp_client_context_t *ctx) {
     switch (ctx->state.task.type) {
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_STOR:
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_APPE: {
+            _uni_net_ftp_client_work_upload(ctx);
+            break;
+        }
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD: {
+            int32_t cnt = 0;
+            do {
+                uint8_t *buf = NULL;
+                cnt = FreeRTOS_recv(ctx->state.socket_data, &buf, ipconfigTCP_MSS,
+                                    FREERTOS_ZERO_COPY | FREERTOS_MSG_DONTWAIT);
+                if (cnt > 0 && buf != NULL) {
+                    // records split across segments are completed in the parser line buffer
+                    uni_net_ftp_list_feed(&ctx->state.list_parser, buf, (size_t)cnt, _uni_net_ftp_client_list_entry, ctx);
+                    ctx->state.task.progress += (uint32_t)cnt;
+                    FreeRTOS_ReleaseTCPPayloadBuffer(ctx->state.socket_data, buf, cnt);
+                } else if (cnt < 0 && ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS) {
+                    // the server closes the data connection after the last entry
+                    uni_net_ftp_list_finish(&ctx->state.list_parser, _uni_net_ftp_client_list_entry, ctx);
+                    ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED;
+                }
+            } while (cnt > 0);
+            break;
+        }
         case UNI_NET_FTP_CLIENT_TASK_TYPE_LIST:
         case UNI_NET_FTP_CLIENT_TASK_TYPE_RETR: {
             int32_t cnt = 0;
@@ -493,13 +1183,29 @@ static void _uni_net_ftp_client_work_data(uni_net_ftp_client_context_t *ctx) {
                     if(ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_STARTED) {
                         ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS;
                     }
-                    if (ctx->state.callback) {
-                        ctx->state.callback(ctx->state.cookie, &ctx->state.task, UNI_NET_FTP_CLIENT_CALLBACK_RECV, buf, cnt);
+                    if (ctx->state.task.progress == 0U) {
+                        ctx->state.data_start = xTaskGetTickCount();
+                    }
+                    // the server keeps sending past the end of a range
+                    uint32_t len = (uint32_t)cnt;
+                    if (ctx->state.task.ranged) {
+                        len = uni_common_math_min(len, ctx->state.task.progress_total - ctx->state.task.progress);
+                    }
+                    // digest the chunk while it is in cache, before the sink stores it
+                    if (ctx->config.digest == UNI_NET_FTP_CLIENT_DIGEST_CRC32 && ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR) {
+                        ctx->state.task.crc32 = uni_net_crc32_update(ctx->state.task.crc32, buf, len);
                     }
-                    ctx->state.task.progress += cnt;
+                    if (ctx->state.callback && len > 0U) {
+                        ctx->state.callback(ctx->state.cookie, &ctx->state.task, UNI_NET_FTP_CLIENT_CALLBACK_RECV, buf, len);
+                    }
+                    ctx->state.task.progress += len;
                     FreeRTOS_ReleaseTCPPayloadBuffer(ctx->state.socket_data, buf, cnt);
+                } else if (cnt < 0 && ctx->state.task.open_ended) {
+                    // the server closes the data connection after the last byte, 226 confirms the file
+                    FreeRTOS_FD_CLR(ctx->state.socket_data, ctx->state.socket_set, eSELECT_ALL);
+                    ctx->state.data_eof = true;
                 }
-            } while (cnt > 0 && ctx->state.task.progress < ctx->state.task.progress_total);
+            } while (cnt > 0 && (ctx->state.task.open_ended || ctx->state.task.progress < ctx->state.task.progress_total));
         }
         default: {
             break;
@@ -534,10 +1240,33 @@ static void _uni_net_ftp_client_work_state_data(uni_net_ftp_client_context_t *ct
         case UNI_NET_FTP_CLIENT_TASK_STATE_STARTED: {
             if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR) {
                 ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_REQUESTED;
+                if (ctx->state.task.offset > 0U) {
+                    // servers announce either the full or the remaining size with RETR after REST,
+                    // SIZE gives the full size unambiguously
+                    if (!ctx->state.task.ranged) {
+                        ctx->state.size_pending = _uni_net_ftp_client_size_file(ctx, ctx->state.task.name);
+                    }
+                    _uni_net_ftp_client_rest(ctx, ctx->state.task.offset);
+                }
                 _uni_net_ftp_client_retr_file(ctx, ctx->state.task.name);
+                if (ctx->state.task.open_ended) {
+                    // closing of the data connection ends the file
+                    FreeRTOS_FD_SET(ctx->state.socket_data, ctx->state.socket_set, eSELECT_EXCEPT);
+                }
             } else if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_LIST){
                 ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_REQUESTED;
                 _uni_net_ftp_client_list_files(ctx);
+            } else if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD) {
+                ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_REQUESTED;
+                uni_net_ftp_list_init(&ctx->state.list_parser, !ctx->state.mlsd_unsupported);
+                _uni_net_ftp_client_list_dir(ctx, ctx->state.mlsd_unsupported ? "LIST" : "MLSD", ctx->state.task.name);
+                // closing of the data connection ends the listing
+                FreeRTOS_FD_SET(ctx->state.socket_data, ctx->state.socket_set, eSELECT_EXCEPT);
+            } else if (_uni_net_ftp_client_is_upload(&ctx->state.task)) {
+                // data is written as soon as there is TX space, the server reads it once STOR is processed
+                ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS;
+                _uni_net_ftp_client_stor_file(ctx, ctx->state.task.name, ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_APPE);
+                FreeRTOS_FD_SET(ctx->state.socket_data, ctx->state.socket_set, eSELECT_WRITE);
             }
             else {
                 _uni_net_ftp_client_set_to_idle(ctx);
@@ -545,18 +1274,29 @@ static void _uni_net_ftp_client_work_state_data(uni_net_ftp_client_context_t *ct
             break;
         }
         case UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS: {
-            if (ctx->state.task.progress >= ctx->state.task.progress_total) {
-                if(ctx->state.callback) {
-                    ctx->state.callback(ctx->state.cookie, &ctx->state.task, UNI_NET_FTP_CLIENT_CALLBACK_RECV_FINISHED, NULL, 0);
+            // an upload ends with the source, a parsed listing with its data connection, an open-ended
+            // retrieval with its data connection and 226
+            bool complete = ctx->state.task.open_ended ? (ctx->state.data_eof && ctx->state.data_confirmed)
+                                                       : (ctx->state.task.progress >= ctx->state.task.progress_total);
+            if (!_uni_net_ftp_client_is_upload(&ctx->state.task) && ctx->state.task.type != UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD
+                && complete) {
+                if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR) {
+                    _uni_net_ftp_client_tune_sample(ctx);
                 }
+                _uni_net_ftp_client_report(ctx, &ctx->state.task, true);
                 _uni_net_ftp_client_set_to_idle(ctx);
             }
             break;
         }
-        case UNI_NET_FTP_CLIENT_TASK_STATE_FAILED: {
-            if(ctx->state.callback) {
-                ctx->state.callback(ctx->state.cookie, &ctx->state.task, UNI_NET_FTP_CLIENT_CALLBACK_RECV_FAILED, NULL, 0);
+        case UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED: {
+            if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD) {
+                _uni_net_ftp_client_report(ctx, &ctx->state.task, true);
+                _uni_net_ftp_client_set_to_idle(ctx);
             }
+            break;
+        }
+        case UNI_NET_FTP_CLIENT_TASK_STATE_FAILED: {
+            _uni_net_ftp_client_report(ctx, &ctx->state.task, false);
             _uni_net_ftp_client_set_to_idle(ctx);
             break;
         }
@@ -566,36 +1306,82 @@ static void _uni_net_ftp_client_work_state_data(uni_net_ftp_client_context_t *ct
     }
 }
 
-static void _uni_net_ftp_client_work_state(uni_net_ftp_client_context_t *ctx) {
-    switch (ctx->state.task.type) {
-        case UNI_NET_FTP_CLIENT_TASK_TYPE_STARTUP: {
-            _uni_net_ftp_client_work_state_startup(ctx);
+static void _uni_net_ftp_client_work_state_mlst(uni_net_ftp_client_context_t *ctx) {
+    switch (ctx->state.task.state) {
+        case UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED: {
+            ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_REQUESTED;
+            _uni_net_ftp_client_list_dir(ctx, "MLST", ctx->state.task.name);
             break;
         }
+        case UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED:
+        case UNI_NET_FTP_CLIENT_TASK_STATE_FAILED: {
+            _uni_net_ftp_client_report(ctx, &ctx->state.task, ctx->state.task.state == UNI_NET_FTP_CLIENT_TASK_STATE_FINISHED);
+            _uni_net_ftp_client_set_to_idle(ctx);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void _uni_net_ftp_client_work_state_task(uni_net_ftp_client_context_t *ctx) {
+    switch (ctx->state.task.type) {
         case UNI_NET_FTP_CLIENT_TASK_TYPE_RETR:
-        case UNI_NET_FTP_CLIENT_TASK_TYPE_LIST: {
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_LIST:
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_STOR:
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_APPE:
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD: {
             _uni_net_ftp_client_work_state_data(ctx);
             break;
         }
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_RETR_PARALLEL: {
+            _uni_net_ftp_client_work_state_parallel(ctx);
+            if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR) {
+                // fell back to a single RETR over this connection
+                _uni_net_ftp_client_work_state_data(ctx);
+            }
+            break;
+        }
+        case UNI_NET_FTP_CLIENT_TASK_TYPE_MLST: {
+            _uni_net_ftp_client_work_state_mlst(ctx);
+            break;
+        }
         default:
             break;
     };
 }
 
+static void _uni_net_ftp_client_work_state(uni_net_ftp_client_context_t *ctx) {
+    if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_STARTUP) {
+        _uni_net_ftp_client_work_state_startup(ctx);
+    } else {
+        _uni_net_ftp_client_work_state_task(ctx);
+    }
 
-static void _uni_net_ftp_client_thread(void *pv) {
-    uni_net_ftp_client_context_t *ctx = pv;
+    // start the next queued task right away, its data connection may already be open
+    if (ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_IDLE && _uni_net_ftp_client_queue_next(ctx)) {
+        _uni_net_ftp_client_work_state_task(ctx);
+    }
+}
 
-    // cleanup
-    _uni_net_ftp_client_disconnect(ctx, false, UNI_NET_FTP_CLIENT_DISCONNECT_REASON_UNKNOWN);
 
-    // prepare
-    ctx->state.task.type = UNI_NET_FTP_CLIENT_TASK_TYPE_STARTUP;
-    ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS;
-    ctx->state.task.progress = 0;
+/**
+ * Run one control connection until it terminates
+ * @param ctx FTP client context pointer
+ * @param logged_in set once the startup sequence completed
+ * @return reason of the termination
+ */
+static uni_net_ftp_client_disconnect_reason_e _uni_net_ftp_client_session(uni_net_ftp_client_context_t *ctx, bool *logged_in) {
+    // prepare, a disconnect requested meanwhile keeps the termination
+    if (!ctx->state.stop_requested) {
+        ctx->state.task.type = UNI_NET_FTP_CLIENT_TASK_TYPE_STARTUP;
+        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_IN_PROGRESS;
+        ctx->state.task.progress = 0;
+    }
 
     uni_net_ftp_client_disconnect_reason_e disconnect_reason = UNI_NET_FTP_CLIENT_DISCONNECT_REASON_TERMINATION;
-    while (ctx->state.task.type != UNI_NET_FTP_CLIENT_TASK_TYPE_TERMINATION) {
+    while (ctx->state.task.type != UNI_NET_FTP_CLIENT_TASK_TYPE_TERMINATION && !ctx->state.stop_requested) {
         // connect command socket
         if (ctx->state.socket_cmd == NULL) {
             if (!_uni_net_ftp_client_connect_socket(ctx, &ctx->state.socket_cmd, ctx->config.server_port)) {
@@ -609,7 +1395,10 @@ static void _uni_net_ftp_client_thread(void *pv) {
         if (select_result != 0) {
             // process incoming command message
             if (FreeRTOS_FD_ISSET(ctx->state.socket_cmd, ctx->state.socket_set)) {
-                _uni_net_ftp_client_work_cmd(ctx);
+                if (!_uni_net_ftp_client_work_cmd(ctx)) {
+                    disconnect_reason = UNI_NET_FTP_CLIENT_DISCONNECT_REASON_NO_BYTES;
+                    break;
+                }
             }
 
             // process incoming data message
@@ -628,13 +1417,96 @@ static void _uni_net_ftp_client_thread(void *pv) {
 
         // Process startup sequence
         _uni_net_ftp_client_work_state(ctx);
+
+        if (ctx->state.task.type != UNI_NET_FTP_CLIENT_TASK_TYPE_STARTUP) {
+            *logged_in = true;
+        }
+    }
+
+    return disconnect_reason;
+}
+
+/**
+ * Prepare a reconnect after the connection was lost: the interrupted task goes back to the queue head
+ * and continues behind the last delivered byte.
+ * @return true in case the client should reconnect
+ */
+static bool _uni_net_ftp_client_resume_prepare(uni_net_ftp_client_context_t *ctx, uni_net_ftp_client_disconnect_reason_e reason,
+                                               uint32_t attempts) {
+    bool result = !ctx->state.stop_requested && attempts < ctx->config.resume_attempts
+               && (reason == UNI_NET_FTP_CLIENT_DISCONNECT_REASON_NETWORK || reason == UNI_NET_FTP_CLIENT_DISCONNECT_REASON_SOCKET
+                || reason == UNI_NET_FTP_CLIENT_DISCONNECT_REASON_NO_BYTES
+                || (reason == UNI_NET_FTP_CLIENT_DISCONNECT_REASON_CONNECT && attempts > 0U));
+
+    if (result) {
+        uni_net_ftp_client_task_t *task = &ctx->state.task;
+        if (task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR) {
+            task->offset += task->progress;
+            task->progress_total = (task->progress_total > task->progress) ? task->progress_total - task->progress : 0U;
+            task->progress = 0;
+            task->sized = false;
+            task->state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED;
+            if (!_uni_net_ftp_client_queue_push_front(ctx, task) && ctx->state.callback) {
+                ctx->state.callback(ctx->state.cookie, task, UNI_NET_FTP_CLIENT_CALLBACK_RECV_FAILED, NULL, 0);
+            }
+        } else if (task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_LIST || task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD
+                   || task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_MLST || task->type == UNI_NET_FTP_CLIENT_TASK_TYPE_RETR_PARALLEL
+                   || _uni_net_ftp_client_is_upload(task)) {
+            // a listing cannot be continued, the lanes of a parallel retrieval depend on this connection,
+            // sent upload data may not have reached the server
+            _uni_net_ftp_client_parallel_stop(ctx);
+            _uni_net_ftp_client_report(ctx, task, false);
+        }
+        _uni_net_ftp_client_set_to_idle(ctx);
+    }
+
+    return result;
+}
+
+static void _uni_net_ftp_client_thread(void *pv) {
+    uni_net_ftp_client_context_t *ctx = pv;
+
+    // cleanup
+    _uni_net_ftp_client_disconnect(ctx, false, UNI_NET_FTP_CLIENT_DISCONNECT_REASON_UNKNOWN);
+    ctx->state.mlsd_unsupported = false;
+
+    uint32_t attempts = 0;
+    uni_net_ftp_client_disconnect_reason_e disconnect_reason;
+    for (;;) {
+        bool logged_in = false;
+        disconnect_reason = _uni_net_ftp_client_session(ctx, &logged_in);
+        if (logged_in) {
+            attempts = 0;
+        }
+
+        if (!_uni_net_ftp_client_resume_prepare(ctx, disconnect_reason, attempts)) {
+            break;
+        }
+        attempts++;
+
+        // reconnect, unless a disconnect is requested during the delay
+        _uni_net_ftp_client_disconnect(ctx, false, disconnect_reason);
+        TickType_t delay_start = xTaskGetTickCount();
+        while (!ctx->state.stop_requested && (xTaskGetTickCount() - delay_start) < pdMS_TO_TICKS(ctx->config.resume_delay_ms)) {
+            vTaskDelay(pdMS_TO_TICKS(UNI_NET_FTP_CLIENT_WAIT_MS));
+        }
+        if (ctx->state.stop_requested) {
+            disconnect_reason = UNI_NET_FTP_CLIENT_DISCONNECT_REASON_TERMINATION;
+            break;
+        }
     }
 
     // disconnect
+    _uni_net_ftp_client_parallel_stop(ctx);
+    _uni_net_ftp_client_queue_fail(ctx);
     _uni_net_ftp_client_disconnect(ctx, true, disconnect_reason);
 
-    // terminate thread
+    // terminate thread, the owner may release the context as soon as exited is given
+    SemaphoreHandle_t exited = ctx->state.exited;
     ctx->state.thread = NULL;
+    if (exited != NULL) {
+        xSemaphoreGive(exited);
+    }
     vTaskDelete(NULL);
 }
 
@@ -656,6 +1528,8 @@ bool uni_net_ftp_client_connect(uni_net_ftp_client_context_t *ctx, uint32_t addr
             ctx->config.server_port = port;
         }
 
+        // cleared here, a disconnect right after the connect must not be lost before the thread runs
+        ctx->state.stop_requested = false;
         result = xTaskCreate(_uni_net_ftp_client_thread, "UNI_NET_FTP_CLIENT", configMINIMAL_STACK_SIZE * 4, ctx, 1,
                               &ctx->state.thread) == pdTRUE;
     }
@@ -666,6 +1540,7 @@ bool uni_net_ftp_client_connect(uni_net_ftp_client_context_t *ctx, uint32_t addr
 bool uni_net_ftp_client_disconnect(uni_net_ftp_client_context_t *ctx) {
     bool result = false;
     if (ctx != NULL) {
+        ctx->state.stop_requested = true;
         ctx->state.task.type = UNI_NET_FTP_CLIENT_TASK_TYPE_TERMINATION;
     }
     return result;
@@ -678,7 +1553,12 @@ bool uni_net_ftp_client_is_connected(const uni_net_ftp_client_context_t *ctx) {
 
 
 bool uni_net_ftp_client_is_idle(const uni_net_ftp_client_context_t *ctx) {
-    return uni_net_ftp_client_is_connected(ctx) && ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_IDLE;
+    return uni_net_ftp_client_is_connected(ctx) && ctx->state.task.type == UNI_NET_FTP_CLIENT_TASK_TYPE_IDLE
+        && ctx->state.queue_count == 0U;
+}
+
+uint32_t uni_net_ftp_client_get_queue_count(const uni_net_ftp_client_context_t *ctx) {
+    return ctx != NULL ? ctx->state.queue_count : 0U;
 }
 
 uint32_t uni_net_ftp_client_get_current_addr(const uni_net_ftp_client_context_t *ctx) {
@@ -705,16 +1585,60 @@ bool uni_net_ftp_client_set_callback(uni_net_ftp_client_context_t *ctx, uni_net_
 
 
 bool uni_net_ftp_client_download(uni_net_ftp_client_context_t *ctx, const char *filename, void *cookie, size_t size) {
+    return uni_net_ftp_client_download_ex(ctx, filename, cookie, size, 0U);
+}
+
+bool uni_net_ftp_client_download_ex(uni_net_ftp_client_context_t *ctx, const char *filename, void *cookie, size_t size, uint32_t offset) {
     bool result = false;
 
-    if (uni_net_ftp_client_is_idle(ctx)) {
-        ctx->state.task.type = UNI_NET_FTP_CLIENT_TASK_TYPE_RETR;
-        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED;
-        ctx->state.task.progress = 0;
-        ctx->state.task.progress_total = size;
-        ctx->state.task.cookie_file = cookie;
-        strncpy(ctx->state.task.name, filename, sizeof(ctx->state.task.name) - 1U);
-        result = true;
+    if (uni_net_ftp_client_is_connected(ctx) && filename != NULL) {
+        uni_net_ftp_client_task_t task = {
+            .type = UNI_NET_FTP_CLIENT_TASK_TYPE_RETR,
+            .state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED,
+            .cookie_file = cookie,
+            .progress = 0,
+            .progress_total = (size > offset) ? size - offset : 0U,
+            .offset = offset,
+        };
+        strncpy(task.name, filename, sizeof(task.name) - 1U);
+        result = _uni_net_ftp_client_queue_push(ctx, &task);
+    }
+
+    return result;
+}
+
+bool uni_net_ftp_client_download_parallel(uni_net_ftp_client_context_t *ctx, const char *filename, void *cookie, uint32_t connections) {
+    bool result = false;
+
+    if (uni_net_ftp_client_is_connected(ctx) && filename != NULL && connections > 0U) {
+        uni_net_ftp_client_task_t task = {
+            .type = UNI_NET_FTP_CLIENT_TASK_TYPE_RETR_PARALLEL,
+            .state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED,
+            .cookie_file = cookie,
+            .parts = uni_common_math_min(connections, UNI_NET_FTP_CLIENT_PARALLEL_MAX),
+        };
+        strncpy(task.name, filename, sizeof(task.name) - 1U);
+        result = _uni_net_ftp_client_queue_push(ctx, &task);
+    }
+
+    return result;
+}
+
+bool uni_net_ftp_client_upload(uni_net_ftp_client_context_t *ctx, const char *filename, void *cookie, size_t size,
+                               uni_net_ftp_client_source_t source, bool append) {
+    bool result = false;
+
+    if (uni_net_ftp_client_is_connected(ctx) && filename != NULL && source != NULL) {
+        uni_net_ftp_client_task_t task = {
+            .type = append ? UNI_NET_FTP_CLIENT_TASK_TYPE_APPE : UNI_NET_FTP_CLIENT_TASK_TYPE_STOR,
+            .state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED,
+            .cookie_file = cookie,
+            .progress = 0,
+            .progress_total = size,
+            .source = source,
+        };
+        strncpy(task.name, filename, sizeof(task.name) - 1U);
+        result = _uni_net_ftp_client_queue_push(ctx, &task);
     }
 
     return result;
@@ -723,13 +1647,46 @@ bool uni_net_ftp_client_download(uni_net_ftp_client_context_t *ctx, const char *
 bool uni_net_ftp_client_list(uni_net_ftp_client_context_t *ctx) {
     bool result = false;
 
-    if (uni_net_ftp_client_is_idle(ctx)) {
-        ctx->state.task.type = UNI_NET_FTP_CLIENT_TASK_TYPE_LIST;
-        ctx->state.task.state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED;
-        ctx->state.task.progress = 0;
-        ctx->state.task.progress_total = 0;
-        ctx->state.task.name[0] = '\0';
-        result = true;
+    if (uni_net_ftp_client_is_connected(ctx)) {
+        uni_net_ftp_client_task_t task = {
+            .type = UNI_NET_FTP_CLIENT_TASK_TYPE_LIST,
+            .state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED,
+        };
+        result = _uni_net_ftp_client_queue_push(ctx, &task);
+    }
+
+    return result;
+}
+
+bool uni_net_ftp_client_list_entries(uni_net_ftp_client_context_t *ctx, const char *path, void *cookie) {
+    bool result = false;
+
+    if (uni_net_ftp_client_is_connected(ctx)) {
+        uni_net_ftp_client_task_t task = {
+            .type = UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD,
+            .state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED,
+            .cookie_file = cookie,
+        };
+        if (path != NULL) {
+            strncpy(task.name, path, sizeof(task.name) - 1U);
+        }
+        result = _uni_net_ftp_client_queue_push(ctx, &task);
+    }
+
+    return result;
+}
+
+bool uni_net_ftp_client_stat_entry(uni_net_ftp_client_context_t *ctx, const char *path, void *cookie) {
+    bool result = false;
+
+    if (uni_net_ftp_client_is_connected(ctx) && path != NULL) {
+        uni_net_ftp_client_task_t task = {
+            .type = UNI_NET_FTP_CLIENT_TASK_TYPE_MLST,
+            .state = UNI_NET_FTP_CLIENT_TASK_STATE_NOT_STARTED,
+            .cookie_file = cookie,
+        };
+        strncpy(task.name, path, sizeof(task.name) - 1U);
+        result = _uni_net_ftp_client_queue_push(ctx, &task);
     }
 
     return result;
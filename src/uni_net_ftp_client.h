@@ -10,6 +10,9 @@
 // FreeRTOS TCP
 #include <FreeRTOS_Sockets.h>
 
+// Uni.Net
+#include "uni_net_ftp_list.h"
+
 
 //
 // Typedefs
@@ -17,11 +20,43 @@
 
 #define UNI_NET_FTP_CLIENT_DEFAULT_PORT (21U)
 
+/**
+ * Number of transfers that can be queued behind the current one
+ */
+#ifndef UNI_NET_FTP_CLIENT_QUEUE_SIZE
+#define UNI_NET_FTP_CLIENT_QUEUE_SIZE (8U)
+#endif
+
+/**
+ * Control channel line buffer size, longer reply lines are truncated
+ */
+#ifndef UNI_NET_FTP_CLIENT_CMD_BUF_SIZE
+#define UNI_NET_FTP_CLIENT_CMD_BUF_SIZE (256U)
+#endif
+
+/**
+ * Maximum number of connections used by one parallel download
+ */
+#ifndef UNI_NET_FTP_CLIENT_PARALLEL_MAX
+#define UNI_NET_FTP_CLIENT_PARALLEL_MAX (4U)
+#endif
+
+/**
+ * Smallest range fetched over its own connection, smaller files use fewer connections
+ */
+#ifndef UNI_NET_FTP_CLIENT_PARALLEL_MIN_RANGE
+#define UNI_NET_FTP_CLIENT_PARALLEL_MIN_RANGE (65536U)
+#endif
+
 typedef enum {
     UNI_NET_FTP_CLIENT_CALLBACK_DISCONNECT = 0,
     UNI_NET_FTP_CLIENT_CALLBACK_RECV = 1,
     UNI_NET_FTP_CLIENT_CALLBACK_RECV_FINISHED = 2,
     UNI_NET_FTP_CLIENT_CALLBACK_RECV_FAILED = 3,
+    UNI_NET_FTP_CLIENT_CALLBACK_SEND = 4,
+    UNI_NET_FTP_CLIENT_CALLBACK_SEND_FINISHED = 5,
+    UNI_NET_FTP_CLIENT_CALLBACK_SEND_FAILED = 6,
+    UNI_NET_FTP_CLIENT_CALLBACK_ENTRY = 7,
 } uni_net_ftp_client_callback_type_e;
 
 typedef enum {
@@ -37,6 +72,15 @@ typedef enum {
     UNI_NET_FTP_CLIENT_DISCONNECT_REASON_SOCKET       = 9,
 } uni_net_ftp_client_disconnect_reason_e;
 
+/**
+ * Digest computed over downloaded data
+ */
+typedef enum {
+    UNI_NET_FTP_CLIENT_DIGEST_NONE = 0,
+    UNI_NET_FTP_CLIENT_DIGEST_CRC32 = 1,
+} uni_net_ftp_client_digest_e;
+
+
 /**
  * FTP Client Task Type
  */
@@ -65,6 +109,31 @@ typedef enum {
      * Client termination
      */
     UNI_NET_FTP_CLIENT_TASK_TYPE_TERMINATION = 4,
+
+    /**
+     * Data retrieval split into ranges over parallel connections
+     */
+    UNI_NET_FTP_CLIENT_TASK_TYPE_RETR_PARALLEL = 5,
+
+    /**
+     * Client data upload, file is created or replaced
+     */
+    UNI_NET_FTP_CLIENT_TASK_TYPE_STOR = 6,
+
+    /**
+     * Client data upload, data is appended to the file
+     */
+    UNI_NET_FTP_CLIENT_TASK_TYPE_APPE = 7,
+
+    /**
+     * Retrieval of parsed directory entries, MLSD or LIST
+     */
+    UNI_NET_FTP_CLIENT_TASK_TYPE_MLSD = 8,
+
+    /**
+     * Retrieval of a single parsed entry over the control connection
+     */
+    UNI_NET_FTP_CLIENT_TASK_TYPE_MLST = 9,
 } uni_net_ftp_client_task_type_e;
 
 
@@ -82,6 +151,16 @@ typedef enum {
 } uni_net_ftp_client_task_state_e;
 
 
+/**
+ * FTP upload data source, writes the next file data straight into the TX stream of the data socket
+ * @param cookie user data connected to file
+ * @param buf free space in the TX stream
+ * @param size size of buf in bytes
+ * @return number of bytes written, 0 once all data was supplied, negative to abort the upload
+ */
+typedef int32_t (*uni_net_ftp_client_source_t)(void *cookie, uint8_t *buf, size_t size);
+
+
 /**
  * FTP Client Task
  */
@@ -111,6 +190,42 @@ typedef struct {
      */
     uint32_t progress_total;
 
+    /**
+     * File offset of the first received byte, data passed to a RECV callback starts at offset + progress
+     */
+    uint32_t offset;
+
+    /**
+     * Retrieval of the byte range [offset, offset + progress_total) started with REST
+     */
+    bool ranged;
+
+    /**
+     * progress_total of a resumed retrieval was taken from the SIZE reply, the size announced with RETR is ignored
+     */
+    bool sized;
+
+    /**
+     * Size unknown: the retrieval ends once the data connection closed and the server confirmed it with 226
+     */
+    bool open_ended;
+
+    /**
+     * Number of connections for a parallel retrieval
+     */
+    uint32_t parts;
+
+    /**
+     * Data source of an upload
+     */
+    uni_net_ftp_client_source_t source;
+
+    /**
+     * Running CRC-32 of the data delivered by RECV callbacks, with UNI_NET_FTP_CLIENT_DIGEST_CRC32.
+     * Covers the file from `offset` on as given at download time, a resumed download continues it.
+     */
+    uint32_t crc32;
+
     /**
      * Char of pathname
      */
@@ -158,6 +273,42 @@ typedef struct {
      * Password
      */
     const char *auth_password;
+
+    /**
+     * Reconnect attempts after the connection was lost (network down, socket closed), 0 to disable.
+     * An interrupted download and the queue are resumed after the reconnect.
+     */
+    uint32_t resume_attempts;
+
+    /**
+     * Delay before every reconnect attempt in ms
+     */
+    uint32_t resume_delay_ms;
+
+    /**
+     * Data socket buffer and window sizes, zero members keep the defaults
+     * (RX 20 MSS buffer / 10 MSS window, TX 4 MSS buffer / 2 MSS window).
+     * Raise the TX sizes for uploads at link rate.
+     */
+    WinProperties_t data_window;
+
+    /**
+     * Lower bound of the autotuned data socket RX buffer in bytes
+     */
+    uint32_t data_rx_buf_min;
+
+    /**
+     * Upper bound of the autotuned data socket RX buffer in bytes, 0 disables autotuning.
+     * With autotuning the RX window of every data socket is sized from the RTT and delivery rate
+     * measured on the previous transfers (bandwidth-delay product), overriding data_window RX sizes.
+     */
+    uint32_t data_rx_buf_max;
+
+    /**
+     * Digest computed while a file is downloaded. RECV_FINISHED of a download passes the result in
+     * data (uint32_t, data_size 4), so the file needs no second read for verification.
+     */
+    uni_net_ftp_client_digest_e digest;
 } uni_net_ftp_client_config_t;
 
 
@@ -170,6 +321,11 @@ typedef struct {
      */
     TaskHandle_t thread;
 
+    /**
+     * Given by the thread right before it exits when set, lets the owner join it
+     */
+    SemaphoreHandle_t exited;
+
     /**
      * Socket set
      */
@@ -185,11 +341,96 @@ typedef struct {
      */
     Socket_t socket_data;
 
+    /**
+     * Data socket opened ahead for the first queued task (PASV sent on the 226 of the transfer still draining)
+     */
+    Socket_t socket_data_next;
+
+    /**
+     * PASV for the first queued task was sent and its reply is pending
+     */
+    bool pasv_next_requested;
+
+    /**
+     * SIZE sent ahead of REST + RETR and its reply is pending
+     */
+    bool size_pending;
+
+    /**
+     * Data connection of an open-ended retrieval was closed by the server after its last byte
+     */
+    bool data_eof;
+
+    /**
+     * 226 received for the running open-ended retrieval
+     */
+    bool data_confirmed;
+
+    /**
+     * Control channel line buffer, keeps the unterminated tail of the last read
+     */
+    char cmd_buf[UNI_NET_FTP_CLIENT_CMD_BUF_SIZE];
+
+    /**
+     * Number of bytes in cmd_buf
+     */
+    uint32_t cmd_len;
+
+    /**
+     * Code of the multi-line reply being received, 0 if none
+     */
+    uint32_t cmd_multiline;
+
+    /**
+     * Rest of a truncated line is dropped up to the next line end
+     */
+    bool cmd_skip;
+
+    /**
+     * Directory listing parser of the running MLSD task
+     */
+    uni_net_ftp_list_parser_t list_parser;
+
+    /**
+     * Server rejected MLSD, directory entries are parsed from LIST
+     */
+    bool mlsd_unsupported;
+
+    /**
+     * Smoothed RTT of the data connection handshakes in ms, 0 until measured
+     */
+    uint32_t data_rtt_ms;
+
+    /**
+     * Autotuned RX window of the next data socket in bytes, 0 for the default
+     */
+    uint32_t data_rx_win;
+
+    /**
+     * Tick of the first received byte of the running download
+     */
+    TickType_t data_start;
+
     /**
      * Client task
      */
     uni_net_ftp_client_task_t task;
 
+    /**
+     * Queued tasks, ring buffer
+     */
+    uni_net_ftp_client_task_t queue[UNI_NET_FTP_CLIENT_QUEUE_SIZE];
+
+    /**
+     * Index of the oldest queued task
+     */
+    uint32_t queue_head;
+
+    /**
+     * Number of queued tasks
+     */
+    uint32_t queue_count;
+
     /**
      * Client callback
      */
@@ -199,6 +440,16 @@ typedef struct {
      * Client callback user data
      */
     void *cookie;
+
+    /**
+     * Connections of the running parallel retrieval
+     */
+    struct uni_net_ftp_client_parallel_s *parallel;
+
+    /**
+     * Disconnect requested by the user, no reconnect
+     */
+    volatile bool stop_requested;
 } uni_net_ftp_client_state_t;
 
 
@@ -251,11 +502,19 @@ bool uni_net_ftp_client_is_connected(const uni_net_ftp_client_context_t *ctx);
 /**
  * Check that client is ready to receive new commanfs
  * @param ctx FTP client context pointer
- * @return true in case client currently doing nothing
+ * @return true in case client currently doing nothing and the queue is empty
  */
 bool uni_net_ftp_client_is_idle(const uni_net_ftp_client_context_t *ctx);
 
 
+/**
+ * Get number of tasks waiting behind the current one
+ * @param ctx FTP client context pointer
+ * @return number of queued tasks
+ */
+uint32_t uni_net_ftp_client_get_queue_count(const uni_net_ftp_client_context_t *ctx);
+
+
 uint32_t uni_net_ftp_client_get_current_addr(const uni_net_ftp_client_context_t *ctx);
 
 /**
@@ -266,23 +525,109 @@ uint32_t uni_net_ftp_client_get_current_addr(const uni_net_ftp_client_context_t
 const uni_net_ftp_client_task_t *uni_net_ftp_client_get_task(const uni_net_ftp_client_context_t *ctx);
 
 /**
- * Download file from FTP server
+ * Queue file download from FTP server. Queued tasks run in order; while one transfer drains, the PASV
+ * for the next one is already sent, so its data connection is open when the transfer finishes.
+ * Completion of every task is reported through the callback (RECV_FINISHED or RECV_FAILED), tasks still
+ * queued on disconnect are reported as RECV_FAILED.
  * @param ctx FTP client context pointer
  * @param filename file name
  * @param cookie user data connected to file
- * @return true in case of successful start
+ * @param size expected file size, replaced by the size announced by the server
+ * @return true in case the task was queued, false if not connected or the queue is full
  */
 bool uni_net_ftp_client_download(uni_net_ftp_client_context_t *ctx, const char *filename, void *cookie, size_t size);
 
 
 /**
+ * Queue file download starting at the given file offset with REST, e.g. to continue a partial file kept by
+ * the application. RECV callbacks report data at task->offset + task->progress. The size announced by the
+ * server is taken as the full file size, so progress_total counts the remaining bytes.
  *
- * @param ctx
- * @return
+ * If the connection is lost and config.resume_attempts is non-zero, the client reconnects and continues
+ * the interrupted download behind the last delivered byte; no DISCONNECT callback is raised unless all
+ * attempts fail.
+ * @param ctx FTP client context pointer
+ * @param filename file name
+ * @param cookie user data connected to file
+ * @param size expected file size, replaced by the size announced by the server
+ * @param offset file offset of the first byte to retrieve
+ * @return true in case the task was queued
+ */
+bool uni_net_ftp_client_download_ex(uni_net_ftp_client_context_t *ctx, const char *filename, void *cookie, size_t size, uint32_t offset);
+
+
+/**
+ * Queue file download split over parallel connections. The size is queried with SIZE, the file is cut
+ * into up to `connections` ranges (at least UNI_NET_FTP_CLIENT_PARALLEL_MIN_RANGE bytes each) and every
+ * range is fetched with REST + RETR over its own control/data connection pair using the credentials in
+ * the context config. A file too small for two ranges, or a server rejecting SIZE, is retrieved with a
+ * single RETR over the connection of this context instead.
+ *
+ * RECV callbacks carry the task of the connection that received the data, so the data starts at file
+ * offset task->offset + task->progress and arrives out of order. Callbacks are serialized but run on the
+ * connection threads. RECV_FINISHED or RECV_FAILED is reported once for the whole file.
+ * @param ctx FTP client context pointer
+ * @param filename file name
+ * @param cookie user data connected to file
+ * @param connections number of connections, 1 to UNI_NET_FTP_CLIENT_PARALLEL_MAX
+ * @return true in case the task was queued
+ */
+bool uni_net_ftp_client_download_parallel(uni_net_ftp_client_context_t *ctx, const char *filename, void *cookie, uint32_t connections);
+
+
+/**
+ * Queue file upload, see uni_net_ftp_client_download(). The data is pulled from `source` on the client
+ * thread whenever the data socket has TX space; source writes directly into the socket TX stream. The
+ * upload ends when source returns 0, the data connection is closed and the task finishes on the server
+ * confirmation.
+ *
+ * task->progress counts the bytes handed to the socket, SEND callbacks report every chunk. Completion is
+ * reported with SEND_FINISHED or SEND_FAILED. An interrupted upload is not resumed.
+ * @param ctx FTP client context pointer
+ * @param filename file name on the server
+ * @param cookie user data connected to file, passed to source
+ * @param size file size if known, used as progress_total
+ * @param source data source
+ * @param append append to the file (APPE) instead of replacing it (STOR)
+ * @return true in case the task was queued
+ */
+bool uni_net_ftp_client_upload(uni_net_ftp_client_context_t *ctx, const char *filename, void *cookie, size_t size,
+                               uni_net_ftp_client_source_t source, bool append);
+
+
+/**
+ * Queue retrieval of the file list, see uni_net_ftp_client_download()
+ * @param ctx FTP client context pointer
+ * @return true in case the task was queued
  */
 bool uni_net_ftp_client_list(uni_net_ftp_client_context_t *ctx);
 
 
+/**
+ * Queue retrieval of parsed directory entries, see uni_net_ftp_client_download(). MLSD is used; if the
+ * server rejects it, the listing is repeated with LIST and the common Unix format is parsed instead.
+ * Every entry is reported with an ENTRY callback as soon as its line arrived, data points to a
+ * uni_net_ftp_list_entry_t valid for the duration of the call. The end of the listing is reported with
+ * RECV_FINISHED or RECV_FAILED.
+ * @param ctx FTP client context pointer
+ * @param path directory, NULL or empty for the current directory
+ * @param cookie user data connected to the listing
+ * @return true in case the task was queued
+ */
+bool uni_net_ftp_client_list_entries(uni_net_ftp_client_context_t *ctx, const char *path, void *cookie);
+
+
+/**
+ * Queue retrieval of a single parsed entry with MLST. The entry is reported with an ENTRY callback,
+ * followed by RECV_FINISHED, or RECV_FAILED if the entry does not exist or MLST is not supported.
+ * @param ctx FTP client context pointer
+ * @param path file or directory
+ * @param cookie user data connected to the entry
+ * @return true in case the task was queued
+ */
+bool uni_net_ftp_client_stat_entry(uni_net_ftp_client_context_t *ctx, const char *path, void *cookie);
+
+
 /**
  * Set FTP client callback
  * @param ctx FTO client context pointer
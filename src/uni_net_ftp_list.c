@@ -0,0 +1,281 @@
+//
+// Includes
+//
+
+// stdlib
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Uni.Net
+#include "uni_net_ftp_list.h"
+
+
+//
+// Defines
+//
+
+#define UNI_NET_FTP_LIST_UNIX_TOKENS (8U)
+
+
+//
+// Function/Helpers
+//
+
+static int32_t _uni_net_ftp_list_digits(const char *str, size_t count) {
+    int32_t result = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (str[i] < '0' || str[i] > '9') {
+            return -1;
+        }
+        result = result * 10 + (str[i] - '0');
+    }
+    return result;
+}
+
+/**
+ * Seconds since 1970-01-01 of a UTC calendar time, 0 if out of range
+ */
+static uint32_t _uni_net_ftp_list_epoch(int32_t year, int32_t month, int32_t day, int32_t hour, int32_t min, int32_t sec) {
+    if (year < 1970 || year > 2105 || month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 || min < 0
+        || min > 59 || sec < 0 || sec > 60) {
+        return 0U;
+    }
+
+    // days from civil, counted from 0000-03-01
+    uint32_t y = (uint32_t)year - (month <= 2 ? 1U : 0U);
+    uint32_t m = (uint32_t)month;
+    uint32_t era = y / 400U;
+    uint32_t yoe = y - era * 400U;
+    uint32_t doy = (153U * (m > 2U ? m - 3U : m + 9U) + 2U) / 5U + (uint32_t)day - 1U;
+    uint32_t doe = yoe * 365U + yoe / 4U - yoe / 100U + doy;
+    uint32_t days = era * 146097U + doe - 719468U;
+
+    return days * 86400U + (uint32_t)hour * 3600U + (uint32_t)min * 60U + (uint32_t)sec;
+}
+
+static int32_t _uni_net_ftp_list_month(const char *str, size_t len) {
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    if (len == 3U) {
+        for (int32_t i = 0; i < 12; i++) {
+            if (strncasecmp(str, &months[i * 3], 3U) == 0) {
+                return i + 1;
+            }
+        }
+    }
+    return -1;
+}
+
+static bool _uni_net_ftp_list_set_name(uni_net_ftp_list_entry_t *entry, const char *name, size_t len) {
+    if (len == 0U || len >= sizeof(entry->name)) {
+        return false;
+    }
+    if ((len == 1U && name[0] == '.') || (len == 2U && name[0] == '.' && name[1] == '.')) {
+        return false;
+    }
+    memcpy(entry->name, name, len);
+    entry->name[len] = '\0';
+    return true;
+}
+
+/**
+ * Parse the completed line and reset the line buffer
+ * @return number of reported entries
+ */
+static uint32_t _uni_net_ftp_list_line(uni_net_ftp_list_parser_t *parser, uni_net_ftp_list_entry_fn fn, void *cookie) {
+    uint32_t result = 0U;
+
+    if (!parser->skip) {
+        if (parser->len > 0U && parser->line[parser->len - 1U] == '\r') {
+            parser->len--;
+        }
+        parser->line[parser->len] = '\0';
+
+        uni_net_ftp_list_entry_t entry;
+        bool parsed = parser->mlsx ? uni_net_ftp_list_parse_mlsx(parser->line, &entry)
+                                   : uni_net_ftp_list_parse_unix(parser->line, &entry);
+        if (parsed) {
+            if (fn != NULL) {
+                fn(cookie, &entry);
+            }
+            result = 1U;
+        }
+    }
+
+    parser->skip = false;
+    parser->len = 0U;
+    return result;
+}
+
+
+//
+// Functions/Public
+//
+
+void uni_net_ftp_list_init(uni_net_ftp_list_parser_t *parser, bool mlsx) {
+    parser->len = 0U;
+    parser->skip = false;
+    parser->mlsx = mlsx;
+}
+
+
+uint32_t uni_net_ftp_list_feed(uni_net_ftp_list_parser_t *parser, const uint8_t *data, size_t size,
+                               uni_net_ftp_list_entry_fn fn, void *cookie) {
+    uint32_t result = 0U;
+
+    while (size > 0U) {
+        const uint8_t *lf = memchr(data, '\n', size);
+        size_t part = (lf != NULL) ? (size_t)(lf - data) : size;
+
+        // one byte stays free for the terminator
+        if (!parser->skip) {
+            if (parser->len + part < sizeof(parser->line)) {
+                memcpy(&parser->line[parser->len], data, part);
+                parser->len += part;
+            } else {
+                parser->skip = true;
+            }
+        }
+
+        if (lf == NULL) {
+            break;
+        }
+        result += _uni_net_ftp_list_line(parser, fn, cookie);
+        data = lf + 1;
+        size -= part + 1U;
+    }
+
+    return result;
+}
+
+
+uint32_t uni_net_ftp_list_finish(uni_net_ftp_list_parser_t *parser, uni_net_ftp_list_entry_fn fn, void *cookie) {
+    uint32_t result = 0U;
+    if (parser->len > 0U || parser->skip) {
+        result = _uni_net_ftp_list_line(parser, fn, cookie);
+    }
+    return result;
+}
+
+
+bool uni_net_ftp_list_parse_mlsx(const char *line, uni_net_ftp_list_entry_t *entry) {
+    memset(entry, 0, sizeof(*entry));
+    entry->type = UNI_NET_FTP_LIST_TYPE_FILE;
+
+    // facts end at the first space, the name is the rest of the line
+    const char *sp = strchr(line, ' ');
+    if (sp == NULL) {
+        return false;
+    }
+
+    const char *fact = line;
+    while (fact < sp) {
+        const char *end = memchr(fact, ';', (size_t)(sp - fact));
+        if (end == NULL) {
+            end = sp;
+        }
+
+        const char *eq = memchr(fact, '=', (size_t)(end - fact));
+        if (eq != NULL) {
+            size_t key_len = (size_t)(eq - fact);
+            const char *val = eq + 1;
+            size_t val_len = (size_t)(end - val);
+
+            if (key_len == 4U && strncasecmp(fact, "type", 4U) == 0) {
+                if (val_len == 4U && strncasecmp(val, "file", 4U) == 0) {
+                    entry->type = UNI_NET_FTP_LIST_TYPE_FILE;
+                } else if (val_len == 3U && strncasecmp(val, "dir", 3U) == 0) {
+                    entry->type = UNI_NET_FTP_LIST_TYPE_DIR;
+                } else if (val_len == 4U && (strncasecmp(val, "cdir", 4U) == 0 || strncasecmp(val, "pdir", 4U) == 0)) {
+                    return false;
+                } else if (val_len >= 13U && strncasecmp(val, "OS.unix=slink", 13U) == 0) {
+                    entry->type = UNI_NET_FTP_LIST_TYPE_LINK;
+                } else {
+                    entry->type = UNI_NET_FTP_LIST_TYPE_OTHER;
+                }
+            } else if (key_len == 4U && strncasecmp(fact, "size", 4U) == 0) {
+                entry->size = strtoull(val, NULL, 10);
+            } else if (key_len == 6U && strncasecmp(fact, "modify", 6U) == 0 && val_len >= 14U) {
+                // YYYYMMDDHHMMSS[.sss]
+                entry->modify = _uni_net_ftp_list_epoch(_uni_net_ftp_list_digits(&val[0], 4U), _uni_net_ftp_list_digits(&val[4], 2U),
+                                                        _uni_net_ftp_list_digits(&val[6], 2U), _uni_net_ftp_list_digits(&val[8], 2U),
+                                                        _uni_net_ftp_list_digits(&val[10], 2U), _uni_net_ftp_list_digits(&val[12], 2U));
+            }
+        }
+
+        fact = end + 1;
+    }
+
+    return _uni_net_ftp_list_set_name(entry, sp + 1, strlen(sp + 1));
+}
+
+
+bool uni_net_ftp_list_parse_unix(const char *line, uni_net_ftp_list_entry_t *entry) {
+    memset(entry, 0, sizeof(*entry));
+
+    // perms links owner [group] size month day time|year name
+    const char *tok[UNI_NET_FTP_LIST_UNIX_TOKENS];
+    size_t tok_len[UNI_NET_FTP_LIST_UNIX_TOKENS];
+    size_t count = 0U;
+    int32_t month = -1;
+    const char *p = line;
+
+    while (count < UNI_NET_FTP_LIST_UNIX_TOKENS) {
+        while (*p == ' ') {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        tok[count] = p;
+        while (*p != '\0' && *p != ' ') {
+            p++;
+        }
+        tok_len[count] = (size_t)(p - tok[count]);
+        count++;
+
+        // the date is found by its month, the group column is optional
+        if (count >= 7U) {
+            month = _uni_net_ftp_list_month(tok[count - 3U], tok_len[count - 3U]);
+            if (month > 0) {
+                break;
+            }
+        }
+    }
+    if (month < 0) {
+        return false;
+    }
+
+    const size_t m = count - 3U;
+    char *size_end = NULL;
+    entry->size = strtoull(tok[m - 1U], &size_end, 10);
+    if (size_end != tok[m - 1U] + tok_len[m - 1U]) {
+        return false;
+    }
+
+    switch (tok[0][0]) {
+        case '-': entry->type = UNI_NET_FTP_LIST_TYPE_FILE; break;
+        case 'd': entry->type = UNI_NET_FTP_LIST_TYPE_DIR; break;
+        case 'l': entry->type = UNI_NET_FTP_LIST_TYPE_LINK; break;
+        default: entry->type = UNI_NET_FTP_LIST_TYPE_OTHER; break;
+    }
+
+    // "HH:MM" is given for recent files instead of the year
+    int32_t day = (tok_len[m + 1U] <= 2U) ? _uni_net_ftp_list_digits(tok[m + 1U], tok_len[m + 1U]) : -1;
+    if (tok_len[m + 2U] == 4U) {
+        entry->modify = _uni_net_ftp_list_epoch(_uni_net_ftp_list_digits(tok[m + 2U], 4U), month, day, 0, 0, 0);
+    }
+
+    while (*p == ' ') {
+        p++;
+    }
+    size_t name_len = strlen(p);
+    if (entry->type == UNI_NET_FTP_LIST_TYPE_LINK) {
+        const char *arrow = strstr(p, " -> ");
+        if (arrow != NULL) {
+            name_len = (size_t)(arrow - p);
+        }
+    }
+
+    return _uni_net_ftp_list_set_name(entry, p, name_len);
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+/*
+ * Streaming parser of FTP directory listings: MLSD/MLST fact lines (RFC 3659) and the common Unix
+ * LIST format. Data is fed in arbitrary chunks, records split across chunks are reassembled in a fixed
+ * line buffer, no heap is used.
+ */
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+//
+// Defines
+//
+
+/**
+ * Longest listing line, longer lines are dropped
+ */
+#ifndef UNI_NET_FTP_LIST_LINE_MAX
+#define UNI_NET_FTP_LIST_LINE_MAX (512U)
+#endif
+
+/**
+ * Entry name buffer size, entries with longer names are dropped
+ */
+#ifndef UNI_NET_FTP_LIST_NAME_MAX
+#define UNI_NET_FTP_LIST_NAME_MAX (64U)
+#endif
+
+
+
+//
+// Typedefs
+//
+
+typedef enum {
+    UNI_NET_FTP_LIST_TYPE_FILE = 0,
+    UNI_NET_FTP_LIST_TYPE_DIR = 1,
+    UNI_NET_FTP_LIST_TYPE_LINK = 2,
+    UNI_NET_FTP_LIST_TYPE_OTHER = 3,
+} uni_net_ftp_list_type_e;
+
+
+/**
+ * Directory entry
+ */
+typedef struct {
+    /**
+     * Entry type
+     */
+    uni_net_ftp_list_type_e type;
+
+    /**
+     * Size in bytes, 0 if unknown
+     */
+    uint64_t size;
+
+    /**
+     * Last modification, UTC seconds since 1970, 0 if unknown. The Unix LIST format omits the year of
+     * recent files, these report 0.
+     */
+    uint32_t modify;
+
+    /**
+     * Entry name, link target stripped
+     */
+    char name[UNI_NET_FTP_LIST_NAME_MAX];
+} uni_net_ftp_list_entry_t;
+
+
+/**
+ * Entry callback
+ */
+typedef void (*uni_net_ftp_list_entry_fn)(void *cookie, const uni_net_ftp_list_entry_t *entry);
+
+
+/**
+ * Parser state
+ */
+typedef struct {
+    /**
+     * Unterminated line of the last chunk
+     */
+    char line[UNI_NET_FTP_LIST_LINE_MAX];
+
+    /**
+     * Number of bytes in line
+     */
+    uint32_t len;
+
+    /**
+     * Rest of an overlong line is dropped up to the next line end
+     */
+    bool skip;
+
+    /**
+     * Lines are MLSx fact lines, Unix LIST lines otherwise
+     */
+    bool mlsx;
+} uni_net_ftp_list_parser_t;
+
+
+
+//
+// Functions
+//
+
+/**
+ * Reset the parser for a new listing
+ * @param parser parser pointer
+ * @param mlsx true for MLSD data, false for LIST data
+ */
+void uni_net_ftp_list_init(uni_net_ftp_list_parser_t *parser, bool mlsx);
+
+/**
+ * Parse the next chunk of listing data
+ * @param parser parser pointer
+ * @param data chunk data
+ * @param size chunk size in bytes
+ * @param fn called for every complete entry, "." and ".." are not reported
+ * @param cookie user data passed to fn
+ * @return number of reported entries
+ */
+uint32_t uni_net_ftp_list_feed(uni_net_ftp_list_parser_t *parser, const uint8_t *data, size_t size,
+                               uni_net_ftp_list_entry_fn fn, void *cookie);
+
+/**
+ * Parse the last line of a listing that does not end with a line end
+ * @return number of reported entries
+ */
+uint32_t uni_net_ftp_list_finish(uni_net_ftp_list_parser_t *parser, uni_net_ftp_list_entry_fn fn, void *cookie);
+
+/**
+ * Parse one MLSx line "fact=value;fact=value; name"
+ * @param line NUL terminated line without line end
+ * @param entry parsed entry
+ * @return true in case the line holds an entry other than "." or ".."
+ */
+bool uni_net_ftp_list_parse_mlsx(const char *line, uni_net_ftp_list_entry_t *entry);
+
+/**
+ * Parse one Unix LIST line "-rw-r--r-- 1 owner group 1234 Jan 01 2024 name"
+ * @param line NUL terminated line without line end
+ * @param entry parsed entry
+ * @return true in case the line holds an entry other than "." or ".."
+ */
+bool uni_net_ftp_list_parse_unix(const char *line, uni_net_ftp_list_entry_t *entry);
@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: MIT
+
+//
+// Includes
+//
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <task.h>
+
+// FreeRTOS+TCP
+#include <FreeRTOS_IP.h>
+#include <FreeRTOS_IP_Private.h>
+
+// Uni.Net
+#include "uni_net_udp_batch.h"
+#include "uni_net_udp_stats.h"
+
+#include "uni_common_math.h"
+
+
+
+//
+// Defines
+//
+
+#if defined(UNI_NET_UDP_CLOCK_DWT)
+#define UNI_NET_UDP_DWT_CTRL                (*(volatile uint32_t*)0xE0001000U)
+#define UNI_NET_UDP_DWT_CYCCNT              (*(volatile uint32_t*)0xE0001004U)
+#define UNI_NET_UDP_DWT_LAR                 (*(volatile uint32_t*)0xE0001FB0U)
+#define UNI_NET_UDP_DEMCR                   (*(volatile uint32_t*)0xE000EDFCU)
+#define UNI_NET_UDP_DEMCR_TRCENA            (1UL << 24U)
+#define UNI_NET_UDP_DWT_CTRL_CYCCNTENA      (1UL << 0U)
+#define UNI_NET_UDP_DWT_LAR_KEY             (0xC5ACCE55U)
+#endif
+
+
+
+//
+// Globals
+//
+
+#if defined(UNI_NET_UDP_CLOCK_DWT)
+static uint32_t g_uni_net_udp_clock_cycles;    // counter value at the last read
+static uint32_t g_uni_net_udp_clock_remainder; // cycles not yet worth a full microsecond
+static uint32_t g_uni_net_udp_clock_us;
+#endif
+
+
+
+//
+// Private
+//
+
+/*
+ * The reception stamp lives in the item value of the network buffer list item: the stack links
+ * network buffers into the free and socket waiting lists by position only and never reads the value.
+ */
+
+#if UNI_NET_UDP_RX_TIMESTAMPS && ( ipconfigUSE_CALLBACKS == 1 )
+static BaseType_t _stamp_receive(Socket_t s, void* data, size_t length, const struct freertos_sockaddr* from, const struct freertos_sockaddr* dest) {
+    (void)s;
+    (void)length;
+    (void)from;
+    (void)dest;
+
+    uni_net_udp_batch_stamp(data);
+    return 0;
+}
+#endif
+
+static UBaseType_t _tx_priority_raise(void) {
+    UBaseType_t priority = 0U;
+#if ( INCLUDE_vTaskPrioritySet == 1 ) && ( INCLUDE_uxTaskPriorityGet == 1 )
+    // Run at IP task priority while queueing: posting TX events then does not preempt us per datagram
+    TaskHandle_t ip_task = FreeRTOS_GetIPTaskHandle();
+    priority = uxTaskPriorityGet(nullptr);
+    if (ip_task != nullptr && ip_task != xTaskGetCurrentTaskHandle()) {
+        UBaseType_t ip_priority = uxTaskPriorityGet(ip_task);
+        if (ip_priority > priority) {
+            vTaskPrioritySet(nullptr, ip_priority);
+        }
+    }
+#endif
+    return priority;
+}
+
+static void _tx_priority_restore(UBaseType_t priority) {
+#if ( INCLUDE_vTaskPrioritySet == 1 ) && ( INCLUDE_uxTaskPriorityGet == 1 )
+    if (uxTaskPriorityGet(nullptr) != priority) {
+        vTaskPrioritySet(nullptr, priority);
+    }
+#else
+    (void)priority;
+#endif
+}
+
+
+
+//
+// Public
+//
+
+size_t uni_net_udp_batch_recv(Socket_t s, uni_net_udp_batch_item_t* items, size_t capacity, bool wait_for_first,
+                              struct uni_net_udp_stats_s* stats) {
+    if (s == nullptr || s == FREERTOS_INVALID_SOCKET || items == nullptr || capacity == 0U) {
+        return 0U;
+    }
+
+    size_t count = 0U;
+    size_t bytes = 0U;
+
+    while (count < capacity) {
+        const BaseType_t flags = ((count == 0U) && wait_for_first) ? 0 : FREERTOS_MSG_DONTWAIT;
+        struct freertos_sockaddr from = {0};
+        uint32_t from_len = sizeof(from);
+        void* payload = nullptr;
+        int32_t rv = FreeRTOS_recvfrom(s, &payload, 0U, (flags | FREERTOS_ZERO_COPY), &from, &from_len);
+
+        if (rv <= 0) {
+            if (payload != nullptr) {
+                FreeRTOS_ReleaseUDPPayloadBuffer(payload);
+            }
+            if (rv < 0 && rv != -pdFREERTOS_ERRNO_EWOULDBLOCK && rv != -pdFREERTOS_ERRNO_ETIMEDOUT && rv != -pdFREERTOS_ERRNO_EINTR) {
+                uni_net_udp_stats_add_drop(stats, UNI_NET_UDP_DROP_STACK_ERROR, 1U);
+            }
+            break;
+        }
+
+        items[count].payload = (const uint8_t*)payload;
+        items[count].length = (size_t)rv;
+        items[count].from.addr = from.sin_address.ulIP_IPv4;
+        items[count].from.port = from.sin_port;
+        bytes += (size_t)rv;
+        count++;
+    }
+
+    uni_net_udp_stats_add_rx(stats, (uint32_t)count, bytes);
+    uni_net_udp_stats_add_batch(stats, (uint32_t)count);
+    return count;
+}
+
+size_t uni_net_udp_batch_send(Socket_t s, uni_net_udp_tx_item_t* items, size_t count) {
+    const UBaseType_t priority = _tx_priority_raise();
+    size_t sent = 0U;
+
+    for (size_t i = 0; i < count; i++) {
+        uni_net_udp_tx_item_t* item = &items[i];
+        int32_t rv = -pdFREERTOS_ERRNO_EINVAL;
+
+        if (item->payload != nullptr && item->length > 0U) {
+            struct freertos_sockaddr to = { 0 };
+            to.sin_family = FREERTOS_AF_INET;
+            to.sin_port = item->to.port;
+            to.sin_address.ulIP_IPv4 = item->to.addr;
+            rv = FreeRTOS_sendto(s, item->payload, item->length, FREERTOS_ZERO_COPY, &to, sizeof(to));
+            if (rv == -pdFREERTOS_ERRNO_EWOULDBLOCK || rv == -pdFREERTOS_ERRNO_ETIMEDOUT) {
+                rv = UNI_NET_UDP_RET_TIMEOUT;
+            }
+        }
+
+        if (rv > 0 && (size_t)rv == item->length) {
+            sent++;
+        } else {
+            // The stack did not take the buffer: it is released here, the caller never gets it back
+            if (rv > 0) {
+                rv = -pdFREERTOS_ERRNO_EINVAL;
+            }
+            uni_net_udp_payload_release(item->payload);
+        }
+
+        item->payload = nullptr;
+        item->result = rv;
+    }
+
+    _tx_priority_restore(priority);
+    return sent;
+}
+
+void uni_net_udp_batch_release(uni_net_udp_batch_item_t* items, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (items[i].payload != nullptr) {
+            FreeRTOS_ReleaseUDPPayloadBuffer((void*)items[i].payload);
+            items[i].payload = nullptr;
+        }
+    }
+}
+
+void uni_net_udp_batch_stamp(void* payload) {
+#if UNI_NET_UDP_RX_TIMESTAMPS
+    NetworkBufferDescriptor_t* buffer = (payload != nullptr) ? pxUDPPayloadBuffer_to_NetworkBuffer(payload) : nullptr;
+    if (buffer != nullptr) {
+        listSET_LIST_ITEM_VALUE(&buffer->xBufferListItem, (TickType_t)UNI_NET_UDP_STATS_CLOCK_US());
+    }
+#else
+    (void)payload;
+#endif
+}
+
+BaseType_t uni_net_udp_batch_stamp_enable(Socket_t s) {
+#if UNI_NET_UDP_RX_TIMESTAMPS && ( ipconfigUSE_CALLBACKS == 1 )
+    F_TCP_UDP_Handler_t handler = {0};
+    handler.pxOnUDPReceive = _stamp_receive;
+    return FreeRTOS_setsockopt(s, 0, FREERTOS_SO_UDP_RECV_HANDLER, &handler, sizeof(handler));
+#else
+    (void)s;
+    return 0;
+#endif
+}
+
+void uni_net_udp_batch_account_delay(struct uni_net_udp_stats_s* stats, const uint8_t* payload, uint32_t now_us) {
+#if UNI_NET_UDP_RX_TIMESTAMPS
+    uni_net_udp_stats_add_queue_delay(stats, now_us - uni_net_udp_payload_rx_time_us(payload));
+#else
+    (void)stats;
+    (void)payload;
+    (void)now_us;
+#endif
+}
+
+#if defined(UNI_NET_UDP_CLOCK_DWT)
+uint32_t uni_net_udp_clock_us(void) {
+    const uint32_t cycles_per_us = uni_common_math_max((uint32_t)(UNI_NET_UDP_STATS_CLOCK_HZ / 1000000U), 1U);
+    uint32_t result;
+
+    taskENTER_CRITICAL();
+    if ((UNI_NET_UDP_DWT_CTRL & UNI_NET_UDP_DWT_CTRL_CYCCNTENA) == 0U) {
+        // Not started by a debugger: enable trace, unlock the DWT where a lock is implemented (Cortex-M7)
+        UNI_NET_UDP_DEMCR |= UNI_NET_UDP_DEMCR_TRCENA;
+        UNI_NET_UDP_DWT_LAR = UNI_NET_UDP_DWT_LAR_KEY;
+        UNI_NET_UDP_DWT_CYCCNT = 0U;
+        UNI_NET_UDP_DWT_CTRL |= UNI_NET_UDP_DWT_CTRL_CYCCNTENA;
+        g_uni_net_udp_clock_cycles = 0U;
+    }
+    const uint32_t cycles = UNI_NET_UDP_DWT_CYCCNT;
+    const uint32_t elapsed = (cycles - g_uni_net_udp_clock_cycles) + g_uni_net_udp_clock_remainder;
+    g_uni_net_udp_clock_cycles = cycles;
+    g_uni_net_udp_clock_us += elapsed / cycles_per_us;
+    g_uni_net_udp_clock_remainder = elapsed % cycles_per_us;
+    result = g_uni_net_udp_clock_us;
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+#endif
+
+uint32_t uni_net_udp_payload_rx_time_us(const uint8_t* payload) {
+#if UNI_NET_UDP_RX_TIMESTAMPS
+    const NetworkBufferDescriptor_t* buffer = (payload != nullptr) ? pxUDPPayloadBuffer_to_NetworkBuffer(payload) : nullptr;
+    return (buffer != nullptr) ? (uint32_t)listGET_LIST_ITEM_VALUE(&buffer->xBufferListItem) : 0U;
+#else
+    (void)payload;
+    return 0U;
+#endif
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+/*
+ * Zero-copy burst receive and batched transmit shared by the UDP server and client (internal to Uni.NET).
+ */
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// FreeRTOS+TCP
+#include <FreeRTOS_IP.h>
+#include <FreeRTOS_Sockets.h>
+
+// Uni.Net
+#include "uni_net_udp_client.h"
+
+
+
+//
+// Typedefs
+//
+
+typedef struct {
+    const uint8_t*         payload;  /* Network buffer payload, release with FreeRTOS_ReleaseUDPPayloadBuffer() */
+    size_t                 length;
+    uni_net_udp_endpoint_t from;
+} uni_net_udp_batch_item_t;
+
+
+
+//
+// Functions
+//
+
+/**
+ * Receive up to capacity datagrams with FREERTOS_ZERO_COPY. The first receive blocks for the socket
+ * RCVTIMEO when wait_for_first is set, the rest use FREERTOS_MSG_DONTWAIT so only already queued
+ * datagrams are drained. Traffic, batch size and stack errors are accounted in stats (may be NULL).
+ * @return number of items filled
+ */
+size_t uni_net_udp_batch_recv(Socket_t s, uni_net_udp_batch_item_t* items, size_t capacity, bool wait_for_first,
+                              struct uni_net_udp_stats_s* stats);
+
+/**
+ * Queue a batch of zero-copy datagrams on s, running at least at the IP task priority meanwhile so the
+ * IP task is woken once for the batch. Every payload is consumed: queued ones are owned by the stack,
+ * failed ones are released here. On return all items[i].payload are NULL and items[i].result holds the
+ * bytes queued, 0 on timeout or a negative error.
+ * @return number of datagrams queued
+ */
+size_t uni_net_udp_batch_send(Socket_t s, uni_net_udp_tx_item_t* items, size_t count);
+
+/**
+ * Return all payloads of a batch to the network buffer pool.
+ */
+void uni_net_udp_batch_release(uni_net_udp_batch_item_t* items, size_t count);
+
+/**
+ * Record the reception time of a datagram payload, called on the IP task from a UDP receive handler.
+ * Read back with uni_net_udp_payload_rx_time_us().
+ */
+void uni_net_udp_batch_stamp(void* payload);
+
+/**
+ * Install a receive handler on s that only stamps datagrams (for sockets without their own handler).
+ * @return 0 on success or when UNI_NET_UDP_RX_TIMESTAMPS is disabled, FreeRTOS_setsockopt() error otherwise
+ */
+BaseType_t uni_net_udp_batch_stamp_enable(Socket_t s);
+
+/**
+ * Account the queueing delay of a payload about to be delivered to a callback.
+ */
+void uni_net_udp_batch_account_delay(struct uni_net_udp_stats_s* stats, const uint8_t* payload, uint32_t now_us);
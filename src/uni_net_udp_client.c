@@ -11,6 +11,7 @@
 
 // FreeRTOS
 #include <FreeRTOS.h>
+#include <task.h>
 #include <semphr.h>
 
 // FreeRTOS+TCP
@@ -19,6 +20,13 @@
 
 // Uni.Net
 #include "uni_net_udp_client.h"
+#include "uni_net_udp_batch.h"
+#include "uni_net_udp_coalesce.h"
+#include "uni_net_udp_igmp.h"
+#include "uni_net_udp_segment.h"
+#include "uni_net_udp_stats.h"
+
+#include "uni_common_math.h"
 
 
 
@@ -57,6 +65,94 @@ static inline bool _socket_valid(Socket_t s) {
     return (s != NULL) && (s != FREERTOS_INVALID_SOCKET);
 }
 
+// Fixed local port, required to accept unsolicited datagrams; the receive task needs a bound socket
+// even without one, as an unbound socket fails every receive at once
+static bool _bind(uni_net_udp_client_context_t* ctx) {
+    if (ctx->config.bind_port == 0U && ctx->config.on_receive == NULL) {
+        return true;
+    }
+    struct freertos_sockaddr local = { 0 };
+    local.sin_family = FREERTOS_AF_INET;
+    local.sin_port = FreeRTOS_htons(ctx->config.bind_port);
+    local.sin_address.ulIP_IPv4 = FREERTOS_INADDR_ANY;
+    return FreeRTOS_bind(ctx->state.socket, &local, sizeof(local)) == 0;
+}
+
+// Asynchronous receive
+static void _uni_net_udp_client_task(void* arg) {
+    uni_net_udp_client_context_t* ctx = (uni_net_udp_client_context_t*)arg;
+    uni_net_udp_batch_item_t batch[UNI_NET_UDP_CLIENT_RX_BATCH_DEPTH] = {0};
+
+    while (!ctx->state.stop_requested) {
+        // Block on the socket whatever rx_timeout_ms is, waking up in time for due IGMP reports
+        TickType_t wait = uni_net_udp_igmp_refresh();
+        if (wait > pdMS_TO_TICKS(UNI_NET_UDP_CLIENT_TASK_WAIT_MS)) {
+            wait = pdMS_TO_TICKS(UNI_NET_UDP_CLIENT_TASK_WAIT_MS);
+        }
+        if (wait == 0U) {
+            wait = 1U;
+        }
+        (void)FreeRTOS_setsockopt(ctx->state.socket, 0, FREERTOS_SO_RCVTIMEO, &wait, sizeof(wait));
+
+        const TickType_t started = xTaskGetTickCount();
+        size_t received = uni_net_udp_batch_recv(ctx->state.socket, batch, UNI_NET_UDP_CLIENT_RX_BATCH_DEPTH, true, ctx->state.stats);
+        for (size_t i = 0; i < received; i++) {
+            const uint32_t cb_started = UNI_NET_UDP_STATS_CLOCK_US();
+            uni_net_udp_batch_account_delay(ctx->state.stats, batch[i].payload, cb_started);
+            ctx->config.on_receive(ctx->config.user, batch[i].payload, batch[i].length, &batch[i].from);
+            uni_net_udp_stats_add_callback_time(ctx->state.stats, UNI_NET_UDP_STATS_CLOCK_US() - cb_started);
+        }
+        uni_net_udp_batch_release(batch, received);
+
+        // Nothing received before the wait ran out: a socket error, do not spin on it
+        if (received == 0U && !ctx->state.stop_requested && (TickType_t)(xTaskGetTickCount() - started) < wait) {
+            vTaskDelay(uni_common_math_max(pdMS_TO_TICKS(UNI_NET_UDP_CLIENT_ERROR_BACKOFF_MS), 1U));
+        }
+    }
+
+    // Task exit, _task_stop() joins on the semaphore
+    ctx->state.task = NULL;
+    (void)xSemaphoreGive(ctx->state.exited);
+    vTaskDelete(NULL);
+}
+
+static bool _task_start(uni_net_udp_client_context_t* ctx) {
+    if (ctx->config.on_receive == NULL) {
+        return true;
+    }
+    if (uni_net_udp_batch_stamp_enable(ctx->state.socket) != 0) {
+        return false;
+    }
+    ctx->state.exited = xSemaphoreCreateBinary();
+    if (ctx->state.exited == NULL) {
+        return false;
+    }
+    if (xTaskCreate(_uni_net_udp_client_task, "UNI_NET_UDP_CLIENT", ctx->config.task_stack_words, ctx,
+                    ctx->config.task_priority, &ctx->state.task) != pdTRUE) {
+        vSemaphoreDelete(ctx->state.exited);
+        ctx->state.exited = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void _task_stop(uni_net_udp_client_context_t* ctx) {
+    if (ctx->state.exited == NULL) {
+        return;
+    }
+
+    ctx->state.stop_requested = true;
+    if (ctx->state.task != NULL) {
+#if ( ipconfigSUPPORT_SIGNALS != 0 )
+        // Interrupt the receive instead of waiting for it to time out
+        (void)FreeRTOS_SignalSocket(ctx->state.socket);
+#endif
+    }
+    (void)xSemaphoreTake(ctx->state.exited, portMAX_DELAY);
+
+    vSemaphoreDelete(ctx->state.exited);
+    ctx->state.exited = NULL;
+}
 
 
 //
@@ -70,30 +166,47 @@ bool uni_net_udp_client_init(uni_net_udp_client_context_t* ctx, const uni_net_ud
         memset(ctx, 0, sizeof(*ctx));
         ctx->config.rx_timeout_ms    = UNI_NET_UDP_DEFAULT_RX_TIMEOUT_MS;
         ctx->config.tx_timeout_ms    = UNI_NET_UDP_DEFAULT_TX_TIMEOUT_MS;
+        ctx->config.task_priority    = UNI_NET_UDP_CLIENT_TASK_PRIORITY;
+        ctx->config.task_stack_words = UNI_NET_UDP_CLIENT_TASK_STACK_WORDS;
         if (cfg != nullptr) {
             ctx->config.rx_timeout_ms    =  cfg->rx_timeout_ms;
             ctx->config.tx_timeout_ms    =  cfg->tx_timeout_ms;
+            ctx->config.bind_port        =  cfg->bind_port;
+            ctx->config.on_receive       =  cfg->on_receive;
+            ctx->config.user             =  cfg->user;
+            if (cfg->task_priority != 0U) {
+                ctx->config.task_priority = cfg->task_priority;
+            }
+            if (cfg->task_stack_words != 0U) {
+                ctx->config.task_stack_words = cfg->task_stack_words;
+            }
         }
 
         ctx->state.lock = xSemaphoreCreateMutex();
+        ctx->state.stats = uni_net_udp_stats_create();
 
-        if (ctx->state.lock != NULL) {
+        if (ctx->state.lock != NULL && ctx->state.stats != NULL) {
             ctx->state.socket = FreeRTOS_socket(FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP);
             if (_socket_valid(ctx->state.socket)) {
-                if(_apply_timeouts(ctx->state.socket, ctx->config.rx_timeout_ms, ctx->config.tx_timeout_ms) == 0) {
+                if(_apply_timeouts(ctx->state.socket, ctx->config.rx_timeout_ms, ctx->config.tx_timeout_ms) == 0
+                   && _bind(ctx)
+                   && _task_start(ctx)) {
                     result = true;
                     ctx->state.initialized = true;
                 }
                 else {
                     FreeRTOS_closesocket(ctx->state.socket);
-                    vSemaphoreDelete(ctx->state.lock);
-                    memset(ctx, 0, sizeof(*ctx));
+                    ctx->state.socket = FREERTOS_INVALID_SOCKET;
                 }
             }
-            else {
+        }
+
+        if (!result) {
+            if (ctx->state.lock != NULL) {
                 vSemaphoreDelete(ctx->state.lock);
-                memset(ctx, 0, sizeof(*ctx));
             }
+            uni_net_udp_stats_delete(ctx->state.stats);
+            memset(ctx, 0, sizeof(*ctx));
         }
     }
 
@@ -109,7 +222,10 @@ bool uni_net_udp_client_deinit(uni_net_udp_client_context_t* ctx) {
         return false;
     }
 
+    ctx->state.initialized = false;
+    _task_stop(ctx);
     _lock(ctx);
+    uni_net_udp_igmp_set_clear(&ctx->state.mcast);
     if (_socket_valid(ctx->state.socket)) {
         FreeRTOS_closesocket(ctx->state.socket);
         ctx->state.socket = FREERTOS_INVALID_SOCKET;
@@ -120,6 +236,7 @@ bool uni_net_udp_client_deinit(uni_net_udp_client_context_t* ctx) {
     if (ctx->state.lock != NULL) {
         vSemaphoreDelete(ctx->state.lock);
     }
+    uni_net_udp_stats_delete(ctx->state.stats);
 
     memset(ctx, 0, sizeof(*ctx));
     return true;
@@ -158,11 +275,10 @@ int32_t uni_net_udp_client_send(uni_net_udp_client_context_t* ctx, const uint8_t
         return -pdFREERTOS_ERRNO_ENOTCONN;
     }
 
-    _lock(ctx);
     int32_t rv = FreeRTOS_send(ctx->state.socket, buf, (int32_t)len, 0);
-    _unlock(ctx);
 
     rv = _map_timeout_to_wouldblock(rv);
+    uni_net_udp_stats_add_tx_result(ctx->state.stats, rv);
     if (rv > 0 && (size_t)rv != len) {
         return -pdFREERTOS_ERRNO_EINVAL;
     }
@@ -179,30 +295,59 @@ int32_t uni_net_udp_client_sendto(uni_net_udp_client_context_t* ctx, const uint8
     to.sin_port = remote->port;
     to.sin_address.ulIP_IPv4 = remote->addr;
 
-    _lock(ctx);
     int32_t rv = FreeRTOS_sendto(ctx->state.socket, buf, (int32_t)len, 0, &to, sizeof(to));
-    _unlock(ctx);
 
     rv = _map_timeout_to_wouldblock(rv);
+    uni_net_udp_stats_add_tx_result(ctx->state.stats, rv);
     if (rv > 0 && (size_t)rv != len) {
         return -pdFREERTOS_ERRNO_EINVAL;
     }
     return rv;
 }
 
+int32_t uni_net_udp_client_sendto_batch(uni_net_udp_client_context_t* ctx, uni_net_udp_tx_item_t* items, size_t count) {
+    if (ctx == NULL || items == NULL || count == 0 || !uni_net_udp_client_is_inited(ctx)) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+
+    size_t sent = uni_net_udp_batch_send(ctx->state.socket, items, count);
+
+    for (size_t i = 0; i < count; i++) {
+        uni_net_udp_stats_add_tx_result(ctx->state.stats, items[i].result);
+    }
+
+    return (int32_t)sent;
+}
+
+int32_t uni_net_udp_client_sendto_large(uni_net_udp_client_context_t* ctx, const uint8_t* buf, size_t len, const uni_net_udp_endpoint_t* remote) {
+    if (ctx == NULL || !uni_net_udp_client_is_inited(ctx)) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+    return uni_net_udp_segment_send(uni_net_udp_coalesce_client_sender, ctx, remote, buf, len, ctx->config.tx_timeout_ms);
+}
+
 int32_t uni_net_udp_client_recvfrom(uni_net_udp_client_context_t* ctx, uint8_t* buf, size_t buf_size, uni_net_udp_endpoint_t* out_src) {
     if (ctx == NULL || buf == NULL || buf_size == 0 || !uni_net_udp_client_is_inited(ctx)) {
         return -pdFREERTOS_ERRNO_EINVAL;
     }
+    if (ctx->state.task != NULL) {
+        return -pdFREERTOS_ERRNO_EALREADY;
+    }
+
+    (void)uni_net_udp_igmp_refresh();
 
     struct freertos_sockaddr from = {0};
     uint32_t from_len = sizeof(from);
 
-    _lock(ctx);
+    // No lock: a blocking receive must not stall senders sharing the socket
     int32_t rv = FreeRTOS_recvfrom(ctx->state.socket, buf, (int32_t)buf_size, 0, &from, &from_len);
-    _unlock(ctx);
 
     rv = _map_timeout_to_wouldblock(rv);
+    if (rv > 0) {
+        uni_net_udp_stats_add_rx(ctx->state.stats, 1U, (size_t)rv);
+    } else if (rv < 0) {
+        uni_net_udp_stats_add_drop(ctx->state.stats, UNI_NET_UDP_DROP_STACK_ERROR, 1U);
+    }
     if (rv >= 0 && out_src != NULL && from_len >= sizeof(from)) {
         out_src->addr = from.sin_address.ulIP_IPv4;
         out_src->port = from.sin_port;
@@ -210,6 +355,13 @@ int32_t uni_net_udp_client_recvfrom(uni_net_udp_client_context_t* ctx, uint8_t*
     return rv;
 }
 
+bool uni_net_udp_client_get_stats(const uni_net_udp_client_context_t* ctx, uni_net_udp_stats_t* out_stats) {
+    if (ctx == NULL || out_stats == NULL) {
+        return false;
+    }
+    return uni_net_udp_stats_snapshot(ctx->state.stats, out_stats);
+}
+
 bool uni_net_udp_client_set_timeouts(uni_net_udp_client_context_t* ctx, uint32_t rx_timeout_ms, uint32_t tx_timeout_ms) {
     if (ctx == NULL || !uni_net_udp_client_is_inited(ctx)) {
         return false;
@@ -236,3 +388,23 @@ bool uni_net_udp_client_get_timeouts(const uni_net_udp_client_context_t* ctx, ui
     }
     return true;
 }
+
+bool uni_net_udp_client_join_group(uni_net_udp_client_context_t* ctx, uint32_t group) {
+    if (ctx == NULL || !uni_net_udp_client_is_inited(ctx)) {
+        return false;
+    }
+    _lock(ctx);
+    const bool result = uni_net_udp_igmp_set_join(&ctx->state.mcast, group);
+    _unlock(ctx);
+    return result;
+}
+
+bool uni_net_udp_client_leave_group(uni_net_udp_client_context_t* ctx, uint32_t group) {
+    if (ctx == NULL || !uni_net_udp_client_is_inited(ctx)) {
+        return false;
+    }
+    _lock(ctx);
+    const bool result = uni_net_udp_igmp_set_leave(&ctx->state.mcast, group);
+    _unlock(ctx);
+    return result;
+}
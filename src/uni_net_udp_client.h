@@ -51,6 +51,96 @@ extern "C" {
 #define UNI_NET_UDP_RET_TIMEOUT (0)
 #endif
 
+/**
+ * Receive task parameters for the asynchronous receive mode (config.on_receive != NULL).
+ */
+#ifndef UNI_NET_UDP_CLIENT_TASK_STACK_WORDS
+#define UNI_NET_UDP_CLIENT_TASK_STACK_WORDS (configMINIMAL_STACK_SIZE * 2U)
+#endif
+
+#ifndef UNI_NET_UDP_CLIENT_TASK_PRIORITY
+#define UNI_NET_UDP_CLIENT_TASK_PRIORITY    (2U)
+#endif
+
+#ifndef UNI_NET_UDP_CLIENT_RX_BATCH_DEPTH
+#define UNI_NET_UDP_CLIENT_RX_BATCH_DEPTH   (8U)
+#endif
+
+/**
+ * Longest receive wait of the receive task; bounds how late a new multicast group gets its periodic
+ * reports and how long deinit waits for the task without ipconfigSUPPORT_SIGNALS.
+ */
+#ifndef UNI_NET_UDP_CLIENT_TASK_WAIT_MS
+#define UNI_NET_UDP_CLIENT_TASK_WAIT_MS     (1000U)
+#endif
+
+/**
+ * Pause of the receive task after a receive error, instead of retrying at once.
+ */
+#ifndef UNI_NET_UDP_CLIENT_ERROR_BACKOFF_MS
+#define UNI_NET_UDP_CLIENT_ERROR_BACKOFF_MS (10U)
+#endif
+
+/**
+ * Number of log2 buckets in the batch-size histogram: 1, 2-3, 4-7, 8-15, 16-31, 32+.
+ */
+#ifndef UNI_NET_UDP_STATS_BATCH_BUCKETS
+#define UNI_NET_UDP_STATS_BATCH_BUCKETS     (6U)
+#endif
+
+/**
+ * Number of log2 buckets in the callback time histogram: 0-1us, 2-3us, 4-7us ... last bucket is open-ended.
+ */
+#ifndef UNI_NET_UDP_STATS_TIME_BUCKETS
+#define UNI_NET_UDP_STATS_TIME_BUCKETS      (16U)
+#endif
+
+/**
+ * Microsecond clock used for callback timing and receive stamps. Defaults to the DWT cycle counter on
+ * Armv7-M and Armv8-M mainline cores (uni_net_udp_clock_us(), enabled on first use). Other targets fall
+ * back to the tick count (e.g. host builds): its resolution, 1 ms at 1 kHz, folds most samples into a
+ * few buckets and sub-tick callbacks read as 0 us. Supply a finer clock here on such targets.
+ * UNI_NET_UDP_STATS_CLOCK_TICK is defined while the fallback is in use.
+ */
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define UNI_NET_UDP_CLOCK_DWT               (1)
+#endif
+
+#ifndef UNI_NET_UDP_STATS_CLOCK_US
+#if defined(UNI_NET_UDP_CLOCK_DWT)
+#define UNI_NET_UDP_STATS_CLOCK_US()        uni_net_udp_clock_us()
+#else
+#define UNI_NET_UDP_STATS_CLOCK_TICK        (1)
+#define UNI_NET_UDP_STATS_CLOCK_US()        ((uint32_t)xTaskGetTickCount() * (1000000U / configTICK_RATE_HZ))
+#endif
+#endif
+
+/**
+ * Core clock feeding the DWT cycle counter.
+ */
+#ifndef UNI_NET_UDP_STATS_CLOCK_HZ
+#define UNI_NET_UDP_STATS_CLOCK_HZ          (configCPU_CLOCK_HZ)
+#endif
+
+/**
+ * Stamp received datagrams with UNI_NET_UDP_STATS_CLOCK_US() on the IP task, when they are queued on the
+ * socket. Needs a FREERTOS_SO_UDP_RECV_HANDLER and therefore ipconfigUSE_CALLBACKS.
+ */
+#ifndef UNI_NET_UDP_RX_TIMESTAMPS
+#if ( ipconfigUSE_CALLBACKS == 1 )
+#define UNI_NET_UDP_RX_TIMESTAMPS           (1)
+#else
+#define UNI_NET_UDP_RX_TIMESTAMPS           (0)
+#endif
+#endif
+
+/**
+ * IPv4 multicast groups a single client or server context can be a member of.
+ */
+#ifndef UNI_NET_UDP_MCAST_GROUPS_MAX
+#define UNI_NET_UDP_MCAST_GROUPS_MAX        (4U)
+#endif
+
 
 //
 // Endpoint helpers
@@ -64,6 +154,13 @@ typedef struct {
     uint16_t port;  /* UDP port in network byte order (use FreeRTOS_htons on host order) */
 } uni_net_udp_endpoint_t;
 
+/**
+ * Check whether an address (network byte order) is an IPv4 multicast group (224.0.0.0/4).
+ */
+static inline bool uni_net_udp_ipv4_is_multicast(uint32_t addr) {
+    return (FreeRTOS_ntohl(addr) & 0xF0000000U) == 0xE0000000U;
+}
+
 /**
  * Convert 4 octets to IPv4 address (network byte order).
  */
@@ -109,22 +206,146 @@ static inline void uni_net_udp_endpoint_init_quick(uni_net_udp_endpoint_t* ep, u
 }
 
 
+//
+// Zero-copy payload helpers
+//
+
+/**
+ * One datagram of a batched transmit. The payload must come from uni_net_udp_payload_alloc() and is
+ * filled by the application in place; ownership passes to the batch call.
+ */
+typedef struct {
+    uni_net_udp_endpoint_t to;      /* Destination endpoint */
+    uint8_t*               payload; /* Zero-copy payload buffer from uni_net_udp_payload_alloc() */
+    size_t                 length;  /* Number of payload bytes to send */
+    int32_t                result;  /* Filled by *_sendto_batch(): bytes queued, 0 on timeout, <0 on error */
+} uni_net_udp_tx_item_t;
+
+/**
+ * Obtain a UDP payload buffer directly from the network buffer pool (FreeRTOS_GetUDPPayloadBuffer).
+ * Returns NULL if no buffer became available within timeout_ms. Each network buffer descriptor
+ * (ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS) can back one pending payload, so large fan-outs should be
+ * submitted in chunks.
+ */
+static inline uint8_t* uni_net_udp_payload_alloc(size_t length, uint32_t timeout_ms) {
+    return (uint8_t*)FreeRTOS_GetUDPPayloadBuffer_Multi(length, pdMS_TO_TICKS(timeout_ms), ipTYPE_IPv4);
+}
+
+/**
+ * Return an unsent payload buffer to the network buffer pool.
+ */
+static inline void uni_net_udp_payload_release(uint8_t* payload) {
+    if (payload != NULL) {
+        FreeRTOS_ReleaseUDPPayloadBuffer(payload);
+    }
+}
+
+#if defined(UNI_NET_UDP_CLOCK_DWT)
+/**
+ * Free-running microsecond clock extended from the DWT cycle counter, wraps at 2^32 us. Differences are
+ * exact as long as the clock is read at least once per counter wrap (2^32 core cycles).
+ */
+uint32_t uni_net_udp_clock_us(void);
+#endif
+
+/**
+ * Reception time (UNI_NET_UDP_STATS_CLOCK_US() domain) of a zero-copy payload handed to an on_receive or
+ * on_receive_ip callback, taken when the IP task queued the datagram on the socket. Subtract it from the
+ * current clock to get the queueing delay. Returns 0 if UNI_NET_UDP_RX_TIMESTAMPS is disabled.
+ */
+uint32_t uni_net_udp_payload_rx_time_us(const uint8_t* payload);
+
+
+//
+// Batch receive
+//
+
+/**
+ * One datagram of a batched copying receive.
+ */
+typedef struct {
+    uint8_t*               buf;      /* Destination buffer provided by the caller */
+    size_t                 buf_size; /* Size of buf in bytes; excess datagram bytes are discarded */
+    size_t                 length;   /* Filled by *_recv_batch(): number of bytes copied into buf */
+    uni_net_udp_endpoint_t from;     /* Filled by *_recv_batch(): source endpoint */
+} uni_net_udp_rx_item_t;
+
+
+//
+// Statistics
+//
+
+typedef enum {
+    UNI_NET_UDP_DROP_STACK_ERROR  = 0, /* FreeRTOS_recvfrom() returned an error */
+    UNI_NET_UDP_DROP_NO_CALLBACK  = 1, /* Datagram received with no callback to deliver it to */
+    UNI_NET_UDP_DROP_RATE_LIMITED = 2, /* Source exceeded its rate limit */
+    UNI_NET_UDP_DROP_QUEUE_FULL   = 3, /* Internal hand-over queue (worker ring) was full */
+    UNI_NET_UDP_DROP_REASON_COUNT = 4,
+} uni_net_udp_drop_reason_e;
+
+/**
+ * Statistics snapshot. Counters are monotonic since init/start.
+ */
+typedef struct {
+    uint64_t rx_packets;
+    uint64_t rx_bytes;
+    uint64_t tx_packets;
+    uint64_t tx_bytes;
+    uint64_t tx_errors;
+    uint64_t drops[UNI_NET_UDP_DROP_REASON_COUNT];
+    uint64_t batch_hist[UNI_NET_UDP_STATS_BATCH_BUCKETS];       /* Datagrams per receive batch */
+    uint64_t callback_us_hist[UNI_NET_UDP_STATS_TIME_BUCKETS];  /* Receive callback execution time */
+    uint32_t callback_us_max;
+    uint64_t queue_delay_us_hist[UNI_NET_UDP_STATS_TIME_BUCKETS]; /* IP task reception to callback start (UNI_NET_UDP_RX_TIMESTAMPS) */
+    uint32_t queue_delay_us_max;
+    uint32_t queue_high_water;                                  /* Most datagrams drained from the socket in one burst */
+    uint32_t rx_batch_depth;                                    /* Adaptive receive batch depth of the last adapted port (server) */
+    uint32_t rx_burst_budget;                                   /* Adaptive burst budget of the last adapted port (server) */
+} uni_net_udp_stats_t;
+
+
 //
 // Client context
 //
 
+/**
+ * Receive callback for the asynchronous receive mode. Called from the client's receive task;
+ * payload points into the network buffer (zero-copy) and is valid for the duration of the callback.
+ */
+typedef void (*uni_net_udp_client_recv_cb)(void* user, const uint8_t* payload, size_t length, const uni_net_udp_endpoint_t* from);
+
 typedef struct {
     uint32_t rx_timeout_ms;     /* Receive timeout in milliseconds */
     uint32_t tx_timeout_ms;     /* Send timeout in milliseconds */
+    uint16_t bind_port;         /* Local port (host byte order), 0 to let the stack pick one (at init with on_receive, on first send otherwise) */
+
+    // Asynchronous receive mode
+    uni_net_udp_client_recv_cb on_receive;       /* Optional: deliver datagrams from an internal task instead of recvfrom */
+    void*                      user;             /* User context pointer passed to callback */
+    UBaseType_t                task_priority;    /* Receive task priority, 0 for UNI_NET_UDP_CLIENT_TASK_PRIORITY */
+    uint32_t                   task_stack_words; /* Receive task stack in words, 0 for UNI_NET_UDP_CLIENT_TASK_STACK_WORDS */
 } uni_net_udp_client_config_t;
 
+/**
+ * Multicast groups joined through one context; left automatically when the context is torn down.
+ */
+typedef struct {
+    uint32_t groups[UNI_NET_UDP_MCAST_GROUPS_MAX];  /* Network byte order */
+    uint32_t count;
+} uni_net_udp_mcast_set_t;
+
 typedef struct {
     bool            initialized;
     Socket_t        socket;
     bool            connected;      /* default remote configured */
     bool            stack_connected; /* FreeRTOS_connect succeeded */
     struct freertos_sockaddr default_remote; /* valid when connected == true */
-    SemaphoreHandle_t lock; /* serialize config and I/O */
+    SemaphoreHandle_t lock; /* serialize configuration changes; send/receive paths do not take it */
+    struct uni_net_udp_stats_s* stats;
+    TaskHandle_t    task;           /* receive task in asynchronous mode */
+    SemaphoreHandle_t exited;       /* given by the receive task on exit */
+    volatile bool   stop_requested;
+    uni_net_udp_mcast_set_t mcast;  /* joined multicast groups */
 } uni_net_udp_client_state_t;
 
 typedef struct {
@@ -145,6 +366,12 @@ typedef struct {
  * an API to detect network readiness (FreeRTOS_IsNetworkUp), the socket is created regardless; however,
  * DNS resolution attempts will naturally fail until the network is up.
  *
+ * If cfg->on_receive is set, the socket is bound (to an ephemeral port when bind_port is 0) and a receive
+ * task is started that burst-drains the socket with zero-copy receives (same batching as the UDP server)
+ * and hands every datagram to the callback; the payload is returned to the stack afterwards. The task
+ * waits for traffic up to UNI_NET_UDP_CLIENT_TASK_WAIT_MS at a time whatever rx_timeout_ms is.
+ * uni_net_udp_client_recvfrom() is unavailable in this mode.
+ *
  * Parameters:
  *  - ctx: Context to initialize (must not be NULL).
  *  - cfg: Optional configuration. If NULL, defaults are used.
@@ -164,6 +391,7 @@ bool uni_net_udp_client_is_inited(const uni_net_udp_client_context_t* ctx);
 
 /**
  * Deinitialize client and close socket. Safe to call multiple times.
+ * Tasks using the client for send/receive must be stopped first: the data path is lock-free.
  */
 bool uni_net_udp_client_deinit(uni_net_udp_client_context_t* ctx);
 
@@ -182,6 +410,12 @@ bool uni_net_udp_client_connect(uni_net_udp_client_context_t* ctx, const uni_net
  */
 bool uni_net_udp_client_is_connected(const uni_net_udp_client_context_t* ctx);
 
+/**
+ * Thread safety: send/sendto/sendto_batch and recvfrom take no client lock and may run concurrently
+ * from different tasks (e.g. a dedicated sender and a dedicated receiver sharing one socket);
+ * FreeRTOS+TCP serializes access per socket internally.
+ */
+
 /**
  * Send a single UDP datagram using the connected remote endpoint (set via connect).
  * Guarantees single-datagram semantics. On timeout/would-block returns 0.
@@ -195,7 +429,8 @@ int32_t uni_net_udp_client_send(uni_net_udp_client_context_t* ctx, const uint8_t
 
 /**
  * Send a single UDP datagram to the specified endpoint. Can be used regardless of connection state.
- * On timeout/would-block returns 0.
+ * remote may be a multicast group: the stack derives the group MAC, so one transmission reaches every
+ * member on the link; the sender does not need to join the group. On timeout/would-block returns 0.
  *
  * Returns:
  *  - > 0 : bytes sent (must equal len for success)
@@ -204,6 +439,33 @@ int32_t uni_net_udp_client_send(uni_net_udp_client_context_t* ctx, const uint8_t
  */
 int32_t uni_net_udp_client_sendto(uni_net_udp_client_context_t* ctx, const uint8_t* buf, size_t len, const uni_net_udp_endpoint_t* remote);
 
+/**
+ * Send a batch of zero-copy datagrams. While the batch is submitted the
+ * caller runs at least at the IP task priority, so the IP task is woken once for the whole batch instead
+ * of once per datagram.
+ *
+ * All payload buffers are consumed: successfully queued ones are owned by the stack, failed ones are
+ * released. Per-item results are stored in items[i].result.
+ *
+ * Returns:
+ *  - >= 0 : number of datagrams queued for transmission
+ *  -  < 0 : negative FreeRTOS+TCP-style error on invalid arguments (buffers are not touched)
+ */
+int32_t uni_net_udp_client_sendto_batch(uni_net_udp_client_context_t* ctx, uni_net_udp_tx_item_t* items, size_t count);
+
+/**
+ * Send a payload of any size up to the segment format limit (see uni_net_udp_segment.h). The payload is
+ * split into MTU-sized datagrams with a sequence header, each copied once into a zero-copy network
+ * buffer and submitted in batches; uni_net_udp_reasm_push() reassembles it on the receive side.
+ * Small payloads are sent as a single segment, so the receiver always sees the segment format.
+ *
+ * Returns:
+ *  - > 0 : len, all segments queued
+ *  -   0 : timeout waiting for network buffers (UNI_NET_UDP_RET_TIMEOUT)
+ *  - < 0 : negative FreeRTOS+TCP-style error
+ */
+int32_t uni_net_udp_client_sendto_large(uni_net_udp_client_context_t* ctx, const uint8_t* buf, size_t len, const uni_net_udp_endpoint_t* remote);
+
 /**
  * Receive a single UDP datagram. If out_src is provided, it will be filled with the source endpoint.
  * On timeout/would-block returns 0. If buf_size is smaller than the datagram, the excess is discarded by
@@ -211,10 +473,16 @@ int32_t uni_net_udp_client_sendto(uni_net_udp_client_context_t* ctx, const uint8
  *
  * Returns:
  *  - >= 0 : number of bytes copied into buf (0 indicates timeout)
- *  -  < 0 : negative FreeRTOS+TCP-style error
+ *  -  < 0 : negative FreeRTOS+TCP-style error (-pdFREERTOS_ERRNO_EALREADY in asynchronous receive mode)
  */
 int32_t uni_net_udp_client_recvfrom(uni_net_udp_client_context_t* ctx, uint8_t* buf, size_t buf_size, uni_net_udp_endpoint_t* out_src);
 
+/**
+ * Get a consistent statistics snapshot. Safe to call from any task.
+ * Returns false if concurrent updates kept the snapshot from being consistent; retry later.
+ */
+bool uni_net_udp_client_get_stats(const uni_net_udp_client_context_t* ctx, uni_net_udp_stats_t* out_stats);
+
 /**
  * Configure send/receive timeouts in milliseconds. Values are applied using FreeRTOS_setsockopt with
  * pdMS_TO_TICKS conversion. Thread-safe.
@@ -226,6 +494,24 @@ bool uni_net_udp_client_set_timeouts(uni_net_udp_client_context_t* ctx, uint32_t
  */
 bool uni_net_udp_client_get_timeouts(const uni_net_udp_client_context_t* ctx, uint32_t* rx_timeout_ms, uint32_t* tx_timeout_ms);
 
+/**
+ * Join an IPv4 multicast group (network byte order) on all IPv4 endpoints. Datagrams sent to the group
+ * and the bound port are then delivered to this client. FreeRTOS+TCP has no IGMP support, so the group
+ * MAC is added to the interface filter and IGMPv2 membership reports are generated here; reports are
+ * repeated periodically from the receive path (asynchronous task or recvfrom). Memberships are reference
+ * counted across all clients and servers. Joining a group twice is a no-op. Thread-safe.
+ *
+ * Returns:
+ *  - true on success; false on invalid argument, non-multicast address or when the group tables are full.
+ */
+bool uni_net_udp_client_join_group(uni_net_udp_client_context_t* ctx, uint32_t group);
+
+/**
+ * Leave a multicast group joined with uni_net_udp_client_join_group(). Groups still joined are left by
+ * uni_net_udp_client_deinit(). Thread-safe.
+ */
+bool uni_net_udp_client_leave_group(uni_net_udp_client_context_t* ctx, uint32_t group);
+
 /**
  * Enable or disable broadcast intent. FreeRTOS+TCP allows broadcast to 255.255.255.255 without a socket option; this records preference.
  */
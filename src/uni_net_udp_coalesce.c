@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: MIT
+
+//
+// Includes
+//
+
+// stdlib
+#include <string.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+// Uni.Common
+#include "uni_common_math.h"
+
+// Uni.Net
+#include "uni_net_udp_coalesce.h"
+
+
+
+//
+// Private
+//
+
+static inline void _lock(uni_net_udp_coalesce_context_t* ctx) {
+    (void)xSemaphoreTake(ctx->state.lock, portMAX_DELAY);
+}
+
+static inline void _unlock(uni_net_udp_coalesce_context_t* ctx) {
+    (void)xSemaphoreGive(ctx->state.lock);
+}
+
+/**
+ * Move an open datagram into the outgoing batch. Called under the lock; sending happens after unlock.
+ */
+static void _detach(uni_net_udp_coalesce_dest_t* dest, uni_net_udp_tx_item_t* out, size_t* out_count) {
+    uni_net_udp_tx_item_t* item = &out[(*out_count)++];
+    item->to = dest->to;
+    item->payload = dest->payload;
+    item->length = dest->length;
+    item->result = 0;
+
+    dest->payload = nullptr;
+    dest->length = 0U;
+}
+
+static size_t _send(uni_net_udp_coalesce_context_t* ctx, uni_net_udp_tx_item_t* items, size_t count, uint64_t* reason_counter) {
+    if (count == 0U) {
+        return 0U;
+    }
+
+    const int32_t rv = ctx->config.send(ctx->config.sender, items, count);
+    const size_t sent = (rv > 0) ? (size_t)rv : 0U;
+    if (rv < 0) {
+        // Sender rejected the batch without consuming it
+        for (size_t i = 0; i < count; i++) {
+            uni_net_udp_payload_release(items[i].payload);
+        }
+    }
+
+    _lock(ctx);
+    ctx->state.stats.datagrams += sent;
+    ctx->state.stats.send_errors += count - sent;
+    *reason_counter += sent;
+    _unlock(ctx);
+    return sent;
+}
+
+static uni_net_udp_coalesce_dest_t* _dest_get(uni_net_udp_coalesce_context_t* ctx, const uni_net_udp_endpoint_t* to,
+                                              uni_net_udp_tx_item_t* out, size_t* out_count) {
+    uni_net_udp_coalesce_dest_t* free_dest = nullptr;
+    uni_net_udp_coalesce_dest_t* oldest = nullptr;
+
+    for (uint32_t i = 0; i < UNI_NET_UDP_COALESCE_DESTINATIONS; i++) {
+        uni_net_udp_coalesce_dest_t* dest = &ctx->state.dest[i];
+        if (dest->payload == nullptr) {
+            if (free_dest == nullptr) {
+                free_dest = dest;
+            }
+        } else if (dest->to.addr == to->addr && dest->to.port == to->port) {
+            return dest;
+        } else if (oldest == nullptr || (int32_t)(dest->opened_at - oldest->opened_at) < 0) {
+            oldest = dest;
+        }
+    }
+
+    if (free_dest != nullptr) {
+        return free_dest;
+    }
+
+    // All slots busy with other destinations: evict the oldest datagram
+    _detach(oldest, out, out_count);
+    return oldest;
+}
+
+
+
+//
+// Public
+//
+
+bool uni_net_udp_coalesce_init(uni_net_udp_coalesce_context_t* ctx, const uni_net_udp_coalesce_config_t* cfg) {
+    if (ctx == nullptr || cfg == nullptr || cfg->send == nullptr) {
+        return false;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->config = *cfg;
+    if (ctx->config.datagram_size == 0U || ctx->config.datagram_size > UNI_NET_UDP_COALESCE_DATAGRAM_MAX) {
+        ctx->config.datagram_size = UNI_NET_UDP_COALESCE_DATAGRAM_MAX;
+    }
+    if (ctx->config.datagram_size <= UNI_NET_UDP_COALESCE_RECORD_HEADER) {
+        return false;
+    }
+    if (ctx->config.deadline_ms == 0U) {
+        ctx->config.deadline_ms = UNI_NET_UDP_COALESCE_DEFAULT_DEADLINE_MS;
+    }
+
+    ctx->state.lock = xSemaphoreCreateMutex();
+    if (ctx->state.lock == nullptr) {
+        return false;
+    }
+
+    ctx->state.initialized = true;
+    return true;
+}
+
+bool uni_net_udp_coalesce_deinit(uni_net_udp_coalesce_context_t* ctx) {
+    if (ctx == nullptr || !ctx->state.initialized) {
+        return false;
+    }
+
+    (void)uni_net_udp_coalesce_flush(ctx);
+    ctx->state.initialized = false;
+    vSemaphoreDelete(ctx->state.lock);
+    memset(ctx, 0, sizeof(*ctx));
+    return true;
+}
+
+int32_t uni_net_udp_coalesce_push(uni_net_udp_coalesce_context_t* ctx, const uni_net_udp_endpoint_t* to, const uint8_t* record, size_t length) {
+    if (ctx == nullptr || !ctx->state.initialized || to == nullptr || (record == nullptr && length > 0U)
+        || length > ctx->config.datagram_size - UNI_NET_UDP_COALESCE_RECORD_HEADER || length > UINT16_MAX) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+
+    uint8_t* spare = nullptr;
+    bool stored = false;
+    bool waited = false;
+
+    for (;;) {
+        uni_net_udp_tx_item_t out[2];
+        size_t out_count = 0U;
+        size_t full_count = 0U;
+
+        _lock(ctx);
+        uni_net_udp_coalesce_dest_t* dest = _dest_get(ctx, to, out, &out_count);
+        const size_t evicted_count = out_count;
+
+        if (dest->payload != nullptr && dest->length + UNI_NET_UDP_COALESCE_RECORD_HEADER + length > ctx->config.datagram_size) {
+            _detach(dest, out, &out_count);
+            full_count = 1U;
+        }
+
+        if (dest->payload == nullptr) {
+            // Never wait for a buffer under the lock: take one allocated beforehand, or only a free one
+            dest->payload = (spare != nullptr) ? spare : uni_net_udp_payload_alloc(ctx->config.datagram_size, 0U);
+            spare = nullptr;
+            dest->to = *to;
+            dest->length = 0U;
+            dest->opened_at = xTaskGetTickCount();
+        }
+
+        if (dest->payload != nullptr) {
+            dest->payload[dest->length] = (uint8_t)(length >> 8U);
+            dest->payload[dest->length + 1U] = (uint8_t)length;
+            if (length > 0U) {
+                memcpy(&dest->payload[dest->length + UNI_NET_UDP_COALESCE_RECORD_HEADER], record, length);
+            }
+            dest->length += UNI_NET_UDP_COALESCE_RECORD_HEADER + length;
+            ctx->state.stats.records++;
+            stored = true;
+        }
+        _unlock(ctx);
+
+        (void)_send(ctx, out, evicted_count, &ctx->state.stats.flush_evict);
+        (void)_send(ctx, &out[evicted_count], full_count, &ctx->state.stats.flush_size);
+
+        if (stored || waited || ctx->config.alloc_timeout_ms == 0U) {
+            break;
+        }
+
+        // Pool exhausted: wait for a buffer unlocked, then place the record again as the slots may have changed
+        spare = uni_net_udp_payload_alloc(ctx->config.datagram_size, ctx->config.alloc_timeout_ms);
+        waited = true;
+        if (spare == nullptr) {
+            break;
+        }
+    }
+
+    // Another push opened a datagram for this destination while we waited
+    uni_net_udp_payload_release(spare);
+    return stored ? (int32_t)length : UNI_NET_UDP_RET_TIMEOUT;
+}
+
+uint32_t uni_net_udp_coalesce_poll(uni_net_udp_coalesce_context_t* ctx) {
+    if (ctx == nullptr || !ctx->state.initialized) {
+        return portMAX_DELAY;
+    }
+
+    uni_net_udp_tx_item_t out[UNI_NET_UDP_COALESCE_DESTINATIONS];
+    size_t out_count = 0U;
+    const TickType_t deadline = pdMS_TO_TICKS(ctx->config.deadline_ms);
+    TickType_t next = portMAX_DELAY;
+
+    _lock(ctx);
+    const TickType_t now = xTaskGetTickCount();
+    for (uint32_t i = 0; i < UNI_NET_UDP_COALESCE_DESTINATIONS; i++) {
+        uni_net_udp_coalesce_dest_t* dest = &ctx->state.dest[i];
+        if (dest->payload == nullptr) {
+            continue;
+        }
+        const TickType_t age = now - dest->opened_at;
+        if (age >= deadline) {
+            _detach(dest, out, &out_count);
+        } else {
+            next = uni_common_math_min(next, deadline - age);
+        }
+    }
+    _unlock(ctx);
+
+    (void)_send(ctx, out, out_count, &ctx->state.stats.flush_deadline);
+    return (next == portMAX_DELAY) ? portMAX_DELAY : (uint32_t)(next * portTICK_PERIOD_MS);
+}
+
+size_t uni_net_udp_coalesce_flush(uni_net_udp_coalesce_context_t* ctx) {
+    if (ctx == nullptr || !ctx->state.initialized) {
+        return 0U;
+    }
+
+    uni_net_udp_tx_item_t out[UNI_NET_UDP_COALESCE_DESTINATIONS];
+    size_t out_count = 0U;
+
+    _lock(ctx);
+    for (uint32_t i = 0; i < UNI_NET_UDP_COALESCE_DESTINATIONS; i++) {
+        if (ctx->state.dest[i].payload != nullptr) {
+            _detach(&ctx->state.dest[i], out, &out_count);
+        }
+    }
+    _unlock(ctx);
+
+    return _send(ctx, out, out_count, &ctx->state.stats.flush_explicit);
+}
+
+bool uni_net_udp_coalesce_get_stats(const uni_net_udp_coalesce_context_t* ctx, uni_net_udp_coalesce_stats_t* out_stats) {
+    if (ctx == nullptr || out_stats == nullptr || !ctx->state.initialized) {
+        return false;
+    }
+
+    uni_net_udp_coalesce_context_t* mutable_ctx = (uni_net_udp_coalesce_context_t*)ctx;
+    _lock(mutable_ctx);
+    *out_stats = ctx->state.stats;
+    _unlock(mutable_ctx);
+    return true;
+}
+
+size_t uni_net_udp_coalesce_unpack(const uint8_t* datagram, size_t length, const uni_net_udp_endpoint_t* from,
+                                   uni_net_udp_coalesce_record_cb on_record, void* user) {
+    if (datagram == nullptr || on_record == nullptr) {
+        return 0U;
+    }
+
+    size_t offset = 0U;
+    size_t records = 0U;
+    while (length - offset >= UNI_NET_UDP_COALESCE_RECORD_HEADER) {
+        const size_t record_length = ((size_t)datagram[offset] << 8U) | (size_t)datagram[offset + 1U];
+        offset += UNI_NET_UDP_COALESCE_RECORD_HEADER;
+        if (record_length > length - offset) {
+            break;
+        }
+        on_record(user, &datagram[offset], record_length, from);
+        offset += record_length;
+        records++;
+    }
+    return records;
+}
+
+int32_t uni_net_udp_coalesce_client_sender(void* sender, uni_net_udp_tx_item_t* items, size_t count) {
+    return uni_net_udp_client_sendto_batch((uni_net_udp_client_context_t*)sender, items, count);
+}
+
+int32_t uni_net_udp_coalesce_server_sender(void* sender, uni_net_udp_tx_item_t* items, size_t count) {
+    return uni_net_udp_server_sendto_batch((uni_net_udp_server_context_t*)sender, items, count);
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+// Uni.NET
+#include "uni_net_udp_client.h"
+#include "uni_net_udp_server.h"
+
+
+//
+// Defaults and configuration
+//
+
+/**
+ * Coalesced datagram layout: a sequence of records, each a 2-byte big endian length followed by
+ * that many payload bytes. Zero-length records are allowed.
+ */
+#define UNI_NET_UDP_COALESCE_RECORD_HEADER      (2U)
+
+/**
+ * Default and largest coalesced datagram (one Ethernet MTU worth of UDP payload).
+ */
+#ifndef UNI_NET_UDP_COALESCE_DATAGRAM_MAX
+#define UNI_NET_UDP_COALESCE_DATAGRAM_MAX       (1472U)
+#endif
+
+/**
+ * Number of destinations with an open datagram at the same time. Each open datagram holds one
+ * network buffer descriptor; pushing to a further destination flushes the oldest one.
+ */
+#ifndef UNI_NET_UDP_COALESCE_DESTINATIONS
+#define UNI_NET_UDP_COALESCE_DESTINATIONS       (4U)
+#endif
+
+/**
+ * Default age of an open datagram after which uni_net_udp_coalesce_poll() sends it.
+ */
+#ifndef UNI_NET_UDP_COALESCE_DEFAULT_DEADLINE_MS
+#define UNI_NET_UDP_COALESCE_DEFAULT_DEADLINE_MS (5U)
+#endif
+
+
+//
+// Typedefs
+//
+
+/**
+ * Transmit hook with the signature of uni_net_udp_{client,server}_sendto_batch(); see
+ * uni_net_udp_coalesce_client_sender() and uni_net_udp_coalesce_server_sender().
+ */
+typedef int32_t (*uni_net_udp_coalesce_send_fn)(void* sender, uni_net_udp_tx_item_t* items, size_t count);
+
+/**
+ * Record callback of uni_net_udp_coalesce_unpack(). record points into the datagram.
+ */
+typedef void (*uni_net_udp_coalesce_record_cb)(void* user, const uint8_t* record, size_t length, const uni_net_udp_endpoint_t* from);
+
+typedef struct {
+    uni_net_udp_endpoint_t to;
+    uint8_t*               payload;     /* Open zero-copy buffer, NULL when nothing is pending */
+    size_t                 length;
+    TickType_t             opened_at;
+} uni_net_udp_coalesce_dest_t;
+
+typedef struct {
+    uint64_t records;                   /* Records accepted by push */
+    uint64_t datagrams;                 /* Datagrams queued for transmission */
+    uint64_t flush_size;                /* Datagrams sent because the next record did not fit */
+    uint64_t flush_deadline;            /* Datagrams sent by poll() */
+    uint64_t flush_explicit;            /* Datagrams sent by flush() or deinit */
+    uint64_t flush_evict;               /* Datagrams sent to free a slot for another destination */
+    uint64_t send_errors;               /* Datagrams the sender failed to queue (their records are lost) */
+} uni_net_udp_coalesce_stats_t;
+
+
+//
+// Configuration, State, Context
+//
+
+typedef struct {
+    uni_net_udp_coalesce_send_fn send;  /* Transmit hook (required) */
+    void*                  sender;      /* Client or server context passed to send */
+    uint32_t               datagram_size;   /* Datagram size limit, 0 or larger than UNI_NET_UDP_COALESCE_DATAGRAM_MAX for the maximum */
+    uint32_t               deadline_ms;     /* Max age of an open datagram, 0 for UNI_NET_UDP_COALESCE_DEFAULT_DEADLINE_MS */
+    uint32_t               alloc_timeout_ms; /* Wait for a free network buffer when opening a datagram */
+} uni_net_udp_coalesce_config_t;
+
+typedef struct {
+    bool                         initialized;
+    SemaphoreHandle_t            lock;
+    uni_net_udp_coalesce_dest_t  dest[UNI_NET_UDP_COALESCE_DESTINATIONS];
+    uni_net_udp_coalesce_stats_t stats;
+} uni_net_udp_coalesce_state_t;
+
+typedef struct {
+    uni_net_udp_coalesce_config_t config;
+    uni_net_udp_coalesce_state_t  state;
+} uni_net_udp_coalesce_context_t;
+
+
+//
+// Public API
+//
+
+/**
+ * Initialize a coalescing sender on top of a UDP client or server.
+ *
+ * Returns:
+ *  - true on success; false on invalid arguments or mutex allocation failure.
+ */
+bool uni_net_udp_coalesce_init(uni_net_udp_coalesce_context_t* ctx, const uni_net_udp_coalesce_config_t* cfg);
+
+/**
+ * Flush all pending datagrams and release the context.
+ */
+bool uni_net_udp_coalesce_deinit(uni_net_udp_coalesce_context_t* ctx);
+
+/**
+ * Append one record to the open datagram of its destination. A datagram is sent when the record does
+ * not fit anymore; it is copied once into the network buffer and never sent on its own.
+ * Thread-safe.
+ *
+ * Returns:
+ *  - > 0 : record length (accepted)
+ *  -   0 : no network buffer became available within alloc_timeout_ms (UNI_NET_UDP_RET_TIMEOUT)
+ *  - < 0 : -pdFREERTOS_ERRNO_EINVAL on invalid arguments or a record larger than a datagram
+ */
+int32_t uni_net_udp_coalesce_push(uni_net_udp_coalesce_context_t* ctx, const uni_net_udp_endpoint_t* to, const uint8_t* record, size_t length);
+
+/**
+ * Send datagrams older than deadline_ms. Call periodically, e.g. from the producing task.
+ *
+ * Returns:
+ *  - milliseconds until the next deadline, or portMAX_DELAY when nothing is pending.
+ */
+uint32_t uni_net_udp_coalesce_poll(uni_net_udp_coalesce_context_t* ctx);
+
+/**
+ * Send all open datagrams now.
+ *
+ * Returns:
+ *  - number of datagrams queued for transmission.
+ */
+size_t uni_net_udp_coalesce_flush(uni_net_udp_coalesce_context_t* ctx);
+
+bool uni_net_udp_coalesce_get_stats(const uni_net_udp_coalesce_context_t* ctx, uni_net_udp_coalesce_stats_t* out_stats);
+
+/**
+ * Split a received coalesced datagram into records and hand each to on_record.
+ *
+ * Returns:
+ *  - number of records delivered; parsing stops at the first truncated record.
+ */
+size_t uni_net_udp_coalesce_unpack(const uint8_t* datagram, size_t length, const uni_net_udp_endpoint_t* from,
+                                   uni_net_udp_coalesce_record_cb on_record, void* user);
+
+/**
+ * Batch transmit hooks for config.send (and uni_net_udp_segment_send()), sender is a
+ * uni_net_udp_client_context_t* / uni_net_udp_server_context_t*.
+ */
+int32_t uni_net_udp_coalesce_client_sender(void* sender, uni_net_udp_tx_item_t* items, size_t count);
+
+int32_t uni_net_udp_coalesce_server_sender(void* sender, uni_net_udp_tx_item_t* items, size_t count);
+
+
+//
+// Usage example
+//
+
+/*
+static uni_net_udp_coalesce_context_t telemetry;
+
+void app_telemetry_init(uni_net_udp_client_context_t* client) {
+    uni_net_udp_coalesce_config_t cfg = {
+        .send = uni_net_udp_coalesce_client_sender,
+        .sender = client,
+        .deadline_ms = 10,
+    };
+    (void)uni_net_udp_coalesce_init(&telemetry, &cfg);
+}
+
+void app_telemetry_task(void* arg) {
+    for (;;) {
+        app_record_t rec = app_sample();
+        (void)uni_net_udp_coalesce_push(&telemetry, &collector, (const uint8_t*)&rec, sizeof(rec));
+        (void)uni_net_udp_coalesce_poll(&telemetry);
+    }
+}
+
+// Receiver: inside the on_receive callback
+uni_net_udp_coalesce_unpack(payload, length, from, app_on_record, app);
+*/
+
+#if defined(__cplusplus)
+}
+#endif
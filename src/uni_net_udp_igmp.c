@@ -0,0 +1,321 @@
+// SPDX-License-Identifier: MIT
+
+//
+// Includes
+//
+
+// stdlib
+#include <string.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+// FreeRTOS+TCP
+#include <FreeRTOS_IP.h>
+#include <FreeRTOS_IP_Private.h>
+#include <FreeRTOS_Routing.h>
+#include <NetworkBufferManagement.h>
+
+// Uni.Net
+#include "uni_net_udp_igmp.h"
+
+
+
+//
+// Defines
+//
+
+#define UNI_NET_UDP_IGMP_TYPE_REPORT_V2     (0x16U)
+#define UNI_NET_UDP_IGMP_TYPE_LEAVE         (0x17U)
+
+#define UNI_NET_UDP_IGMP_IP_HEADER_SIZE     (24U)      /* IPv4 header with Router Alert option */
+#define UNI_NET_UDP_IGMP_MESSAGE_SIZE       (8U)
+#define UNI_NET_UDP_IGMP_FRAME_MIN          (60U)      /* Minimum Ethernet frame without FCS */
+#define UNI_NET_UDP_IGMP_ALLOC_TIMEOUT_MS   (10U)
+
+
+
+//
+// Typedefs
+//
+
+typedef struct {
+    uint32_t group;
+    uint32_t refs;
+} uni_net_udp_igmp_entry_t;
+
+
+
+//
+// Globals
+//
+
+static uni_net_udp_igmp_entry_t g_uni_net_udp_igmp_groups[UNI_NET_UDP_IGMP_GROUPS_MAX];
+static TickType_t g_uni_net_udp_igmp_last_report;
+
+// Serializes a first join or last leave with its MAC filter update, so filter changes keep the refcount order
+static SemaphoreHandle_t g_uni_net_udp_igmp_lock;
+
+
+
+//
+// Private
+//
+
+static bool _lock(void) {
+    if (g_uni_net_udp_igmp_lock == nullptr) {
+        // Created on first use; a concurrent first user may have won the race meanwhile
+        SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+        if (lock == nullptr) {
+            return false;
+        }
+        taskENTER_CRITICAL();
+        if (g_uni_net_udp_igmp_lock == nullptr) {
+            g_uni_net_udp_igmp_lock = lock;
+            lock = nullptr;
+        }
+        taskEXIT_CRITICAL();
+        if (lock != nullptr) {
+            vSemaphoreDelete(lock);
+        }
+    }
+    return xSemaphoreTake(g_uni_net_udp_igmp_lock, portMAX_DELAY) == pdTRUE;
+}
+
+static void _unlock(void) {
+    (void)xSemaphoreGive(g_uni_net_udp_igmp_lock);
+}
+
+static uint16_t _checksum(const uint8_t* data, size_t length) {
+    uint32_t sum = 0U;
+    for (size_t i = 0; i + 1U < length; i += 2U) {
+        sum += ((uint32_t)data[i] << 8U) | (uint32_t)data[i + 1U];
+    }
+    if ((length & 1U) != 0U) {
+        sum += (uint32_t)data[length - 1U] << 8U;
+    }
+    while ((sum >> 16U) != 0U) {
+        sum = (sum & 0xFFFFU) + (sum >> 16U);
+    }
+    return (uint16_t)~sum;
+}
+
+static inline void _put_be16(uint8_t* buf, uint16_t value) {
+    buf[0] = (uint8_t)(value >> 8U);
+    buf[1] = (uint8_t)value;
+}
+
+static void _group_mac(uint32_t group, uint8_t* mac) {
+    const uint32_t host = FreeRTOS_ntohl(group);
+    mac[0] = 0x01U;
+    mac[1] = 0x00U;
+    mac[2] = 0x5EU;
+    mac[3] = (uint8_t)((host >> 16U) & 0x7FU);
+    mac[4] = (uint8_t)(host >> 8U);
+    mac[5] = (uint8_t)host;
+}
+
+static void _mac_filter(uint32_t group, bool allow) {
+    uint8_t mac[ipMAC_ADDRESS_LENGTH_BYTES];
+    _group_mac(group, mac);
+
+    for (NetworkInterface_t* itf = FreeRTOS_FirstNetworkInterface(); itf != nullptr; itf = FreeRTOS_NextNetworkInterface(itf)) {
+        NetworkInterfaceMACFilterFunction_t filter = allow ? itf->pfAddAllowedMAC : itf->pfRemoveAllowedMAC;
+        // Interfaces without a filter run promiscuous and already pass the group
+        if (filter != nullptr) {
+            filter(itf, mac);
+        }
+    }
+}
+
+/**
+ * Build an IGMPv2 message in a network buffer and hand it to the IP task for transmission.
+ */
+static void _send_message(NetworkEndPoint_t* endpoint, uint8_t type, uint32_t group) {
+    const uint32_t destination = (type == UNI_NET_UDP_IGMP_TYPE_LEAVE) ? FreeRTOS_inet_addr_quick(224, 0, 0, 2) : group;
+    NetworkBufferDescriptor_t* buffer = pxGetNetworkBufferWithDescriptor(UNI_NET_UDP_IGMP_FRAME_MIN, pdMS_TO_TICKS(UNI_NET_UDP_IGMP_ALLOC_TIMEOUT_MS));
+    if (buffer == nullptr) {
+        return;
+    }
+
+    uint8_t* frame = buffer->pucEthernetBuffer;
+    memset(frame, 0, UNI_NET_UDP_IGMP_FRAME_MIN);
+
+    // Ethernet
+    _group_mac(destination, &frame[0]);
+    memcpy(&frame[6], endpoint->xMACAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES);
+    _put_be16(&frame[12], 0x0800U);
+
+    // IPv4, TTL 1 and Router Alert as required by RFC 2236
+    uint8_t* ip = &frame[ipSIZE_OF_ETH_HEADER];
+    ip[0] = 0x46U;
+    _put_be16(&ip[2], UNI_NET_UDP_IGMP_IP_HEADER_SIZE + UNI_NET_UDP_IGMP_MESSAGE_SIZE);
+    ip[8] = 1U;
+    ip[9] = ipPROTOCOL_IGMP;
+    memcpy(&ip[12], &endpoint->ipv4_settings.ulIPAddress, sizeof(uint32_t));
+    memcpy(&ip[16], &destination, sizeof(uint32_t));
+    ip[20] = 0x94U;
+    ip[21] = 0x04U;
+    _put_be16(&ip[10], _checksum(ip, UNI_NET_UDP_IGMP_IP_HEADER_SIZE));
+
+    // IGMP
+    uint8_t* igmp = &ip[UNI_NET_UDP_IGMP_IP_HEADER_SIZE];
+    igmp[0] = type;
+    memcpy(&igmp[4], &group, sizeof(uint32_t));
+    _put_be16(&igmp[2], _checksum(igmp, UNI_NET_UDP_IGMP_MESSAGE_SIZE));
+
+    buffer->xDataLength = UNI_NET_UDP_IGMP_FRAME_MIN;
+    buffer->pxInterface = endpoint->pxNetworkInterface;
+    buffer->pxEndPoint = endpoint;
+
+    IPStackEvent_t event = { eNetworkTxEvent, buffer };
+    if (xSendEventStructToIPTask(&event, 0U) != pdPASS) {
+        vReleaseNetworkBufferAndDescriptor(buffer);
+    }
+}
+
+static void _send_all(uint8_t type, uint32_t group) {
+    for (NetworkEndPoint_t* ep = FreeRTOS_FirstEndPoint(nullptr); ep != nullptr; ep = FreeRTOS_NextEndPoint(nullptr, ep)) {
+        if (ep->bits.bIPv6 == pdFALSE_UNSIGNED && ep->ipv4_settings.ulIPAddress != 0U && ep->pxNetworkInterface != nullptr) {
+            _send_message(ep, type, group);
+        }
+    }
+}
+
+
+
+//
+// Public
+//
+
+bool uni_net_udp_igmp_join(uint32_t group) {
+    if (!uni_net_udp_ipv4_is_multicast(group)) {
+        return false;
+    }
+
+    bool result = false;
+    bool first = false;
+
+    if (!_lock()) {
+        return false;
+    }
+    // The critical section keeps uni_net_udp_igmp_refresh() lock free
+    taskENTER_CRITICAL();
+    uni_net_udp_igmp_entry_t* free_entry = nullptr;
+    for (uint32_t i = 0; i < UNI_NET_UDP_IGMP_GROUPS_MAX; i++) {
+        uni_net_udp_igmp_entry_t* entry = &g_uni_net_udp_igmp_groups[i];
+        if (entry->refs > 0U && entry->group == group) {
+            entry->refs++;
+            result = true;
+            break;
+        }
+        if (entry->refs == 0U && free_entry == nullptr) {
+            free_entry = entry;
+        }
+    }
+    if (!result && free_entry != nullptr) {
+        free_entry->group = group;
+        free_entry->refs = 1U;
+        result = true;
+        first = true;
+    }
+    taskEXIT_CRITICAL();
+
+    if (first) {
+        _mac_filter(group, true);
+        // Unsolicited reports are sent twice in case the first one is lost (RFC 2236, 3)
+        _send_all(UNI_NET_UDP_IGMP_TYPE_REPORT_V2, group);
+        _send_all(UNI_NET_UDP_IGMP_TYPE_REPORT_V2, group);
+    }
+    _unlock();
+    return result;
+}
+
+bool uni_net_udp_igmp_leave(uint32_t group) {
+    bool result = false;
+    bool last = false;
+
+    if (!_lock()) {
+        return false;
+    }
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < UNI_NET_UDP_IGMP_GROUPS_MAX; i++) {
+        uni_net_udp_igmp_entry_t* entry = &g_uni_net_udp_igmp_groups[i];
+        if (entry->refs > 0U && entry->group == group) {
+            entry->refs--;
+            last = (entry->refs == 0U);
+            result = true;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (last) {
+        _send_all(UNI_NET_UDP_IGMP_TYPE_LEAVE, group);
+        _mac_filter(group, false);
+    }
+    _unlock();
+    return result;
+}
+
+bool uni_net_udp_igmp_set_join(uni_net_udp_mcast_set_t* set, uint32_t group) {
+    for (uint32_t i = 0; i < set->count; i++) {
+        if (set->groups[i] == group) {
+            return true;
+        }
+    }
+    if (set->count >= UNI_NET_UDP_MCAST_GROUPS_MAX || !uni_net_udp_igmp_join(group)) {
+        return false;
+    }
+    set->groups[set->count++] = group;
+    return true;
+}
+
+bool uni_net_udp_igmp_set_leave(uni_net_udp_mcast_set_t* set, uint32_t group) {
+    for (uint32_t i = 0; i < set->count; i++) {
+        if (set->groups[i] == group) {
+            set->groups[i] = set->groups[--set->count];
+            (void)uni_net_udp_igmp_leave(group);
+            return true;
+        }
+    }
+    return false;
+}
+
+void uni_net_udp_igmp_set_clear(uni_net_udp_mcast_set_t* set) {
+    while (set->count > 0U) {
+        (void)uni_net_udp_igmp_leave(set->groups[--set->count]);
+    }
+}
+
+TickType_t uni_net_udp_igmp_refresh(void) {
+    const TickType_t now = xTaskGetTickCount();
+    const TickType_t interval = pdMS_TO_TICKS(UNI_NET_UDP_IGMP_REPORT_INTERVAL_MS);
+    uint32_t groups[UNI_NET_UDP_IGMP_GROUPS_MAX];
+    uint32_t count = 0U;
+    bool joined = false;
+    TickType_t elapsed;
+
+    taskENTER_CRITICAL();
+    elapsed = (TickType_t)(now - g_uni_net_udp_igmp_last_report);
+    for (uint32_t i = 0; i < UNI_NET_UDP_IGMP_GROUPS_MAX; i++) {
+        if (g_uni_net_udp_igmp_groups[i].refs > 0U) {
+            joined = true;
+            if (elapsed >= interval) {
+                groups[count++] = g_uni_net_udp_igmp_groups[i].group;
+            }
+        }
+    }
+    if (elapsed >= interval) {
+        g_uni_net_udp_igmp_last_report = now;
+        elapsed = 0U;
+    }
+    taskEXIT_CRITICAL();
+
+    for (uint32_t i = 0; i < count; i++) {
+        _send_all(UNI_NET_UDP_IGMP_TYPE_REPORT_V2, groups[i]);
+    }
+    return joined ? (TickType_t)(interval - elapsed) : portMAX_DELAY;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+ * IPv4 multicast group membership shared by the UDP client and server (internal to Uni.NET).
+ *
+ * FreeRTOS+TCP delivers datagrams addressed to any IPv4 multicast group that passes the driver MAC
+ * filter but does not implement IGMP. Memberships are reference counted here: the first join of a
+ * group opens the MAC filter of every interface and sends an IGMPv2 membership report, the last leave
+ * closes the filter and sends a leave message. Because queries from the router are not answered,
+ * reports are repeated from uni_net_udp_igmp_refresh().
+ */
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdbool.h>
+#include <stdint.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+
+// Uni.Net
+#include "uni_net_udp_client.h"
+
+
+
+//
+// Defines
+//
+
+/**
+ * Distinct groups joined on the device at the same time.
+ */
+#ifndef UNI_NET_UDP_IGMP_GROUPS_MAX
+#define UNI_NET_UDP_IGMP_GROUPS_MAX          (16U)
+#endif
+
+/**
+ * Unsolicited report period; must stay below the querier's membership timeout (260 s by default).
+ */
+#ifndef UNI_NET_UDP_IGMP_REPORT_INTERVAL_MS
+#define UNI_NET_UDP_IGMP_REPORT_INTERVAL_MS  (60000U)
+#endif
+
+
+
+//
+// Functions
+//
+
+/**
+ * Add a reference to group (network byte order).
+ * @return false if group is not a multicast address or the group table is full
+ */
+bool uni_net_udp_igmp_join(uint32_t group);
+
+/**
+ * Drop a reference to group.
+ * @return false if the group was not joined
+ */
+bool uni_net_udp_igmp_leave(uint32_t group);
+
+/**
+ * Join group on behalf of one context and record it in set; joining a recorded group is a no-op.
+ * @return false if group is not a multicast address or set or the group table is full
+ */
+bool uni_net_udp_igmp_set_join(uni_net_udp_mcast_set_t* set, uint32_t group);
+
+/**
+ * Leave group if it is recorded in set.
+ * @return false if the group is not in set
+ */
+bool uni_net_udp_igmp_set_leave(uni_net_udp_mcast_set_t* set, uint32_t group);
+
+/**
+ * Leave every group recorded in set.
+ */
+void uni_net_udp_igmp_set_clear(uni_net_udp_mcast_set_t* set);
+
+/**
+ * Repeat membership reports when UNI_NET_UDP_IGMP_REPORT_INTERVAL_MS elapsed. Cheap when nothing is due;
+ * called from the UDP server and client receive tasks.
+ * @return ticks until the next report is due, portMAX_DELAY if no group is joined
+ */
+TickType_t uni_net_udp_igmp_refresh(void);
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: MIT
+
+//
+// Includes
+//
+
+// FreeRTOS
+#include <FreeRTOS.h>
+
+// Uni.Net
+#include "uni_net_udp_ring.h"
+
+
+
+//
+// Private
+//
+
+static size_t _round_up_pow2(size_t value) {
+    size_t result = 1U;
+    while (result < value) {
+        result <<= 1U;
+    }
+    return result;
+}
+
+static void _update_high_water(uni_net_udp_ring_t* ring, uint32_t depth) {
+    uint32_t current = atomic_load_explicit(&ring->high_water, memory_order_relaxed);
+    while (depth > current
+        && !atomic_compare_exchange_weak_explicit(&ring->high_water, &current, depth, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+
+
+//
+// Public
+//
+
+uni_net_udp_ring_t* uni_net_udp_ring_create(size_t capacity) {
+    uni_net_udp_ring_t* ring = nullptr;
+
+    if (capacity > 0U) {
+        capacity = _round_up_pow2(capacity);
+        ring = pvPortMalloc(sizeof(*ring));
+        if (ring != nullptr) {
+            ring->cells = pvPortMalloc(capacity * sizeof(ring->cells[0]));
+            if (ring->cells != nullptr) {
+                ring->mask = capacity - 1U;
+                for (size_t i = 0; i < capacity; i++) {
+                    atomic_init(&ring->cells[i].sequence, i);
+                }
+                atomic_init(&ring->head, 0U);
+                atomic_init(&ring->tail, 0U);
+                atomic_init(&ring->high_water, 0U);
+                atomic_init(&ring->overflow_total, 0U);
+            } else {
+                vPortFree(ring);
+                ring = nullptr;
+            }
+        }
+    }
+
+    return ring;
+}
+
+void uni_net_udp_ring_delete(uni_net_udp_ring_t* ring) {
+    if (ring != nullptr) {
+        vPortFree(ring->cells);
+        vPortFree(ring);
+    }
+}
+
+bool uni_net_udp_ring_push(uni_net_udp_ring_t* ring, const uni_net_udp_ring_item_t* item) {
+    size_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    for (;;) {
+        uni_net_udp_ring_cell_t* cell = &ring->cells[pos & ring->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1U, memory_order_relaxed, memory_order_relaxed)) {
+                cell->item = *item;
+                atomic_store_explicit(&cell->sequence, pos + 1U, memory_order_release);
+                _update_high_water(ring, (uint32_t)uni_net_udp_ring_depth(ring));
+                return true;
+            }
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&ring->overflow_total, 1U, memory_order_relaxed);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+}
+
+bool uni_net_udp_ring_pop(uni_net_udp_ring_t* ring, uni_net_udp_ring_item_t* item) {
+    size_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    for (;;) {
+        uni_net_udp_ring_cell_t* cell = &ring->cells[pos & ring->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1U);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->tail, &pos, pos + 1U, memory_order_relaxed, memory_order_relaxed)) {
+                *item = cell->item;
+                atomic_store_explicit(&cell->sequence, pos + ring->mask + 1U, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        }
+    }
+}
+
+size_t uni_net_udp_ring_depth(const uni_net_udp_ring_t* ring) {
+    size_t head = atomic_load_explicit(&((uni_net_udp_ring_t*)ring)->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&((uni_net_udp_ring_t*)ring)->tail, memory_order_relaxed);
+    return (head >= tail) ? (head - tail) : 0U;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+ * Bounded lock-free MPMC ring of received UDP datagrams (internal to Uni.NET).
+ *
+ * Cells carry zero-copy payload pointers obtained from FreeRTOS_recvfrom(FREERTOS_ZERO_COPY);
+ * the consumer is responsible for FreeRTOS_ReleaseUDPPayloadBuffer().
+ */
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Uni.Net
+#include "uni_net_udp_client.h"
+
+
+
+//
+// Typedefs
+//
+
+typedef struct {
+    const uint8_t*         payload;
+    size_t                 length;
+    uni_net_udp_endpoint_t from;
+    uint32_t               port_index;
+} uni_net_udp_ring_item_t;
+
+typedef struct {
+    atomic_size_t           sequence;
+    uni_net_udp_ring_item_t item;
+} uni_net_udp_ring_cell_t;
+
+typedef struct uni_net_udp_ring_s {
+    uni_net_udp_ring_cell_t* cells;
+    size_t                   mask;
+    atomic_size_t            head;
+    atomic_size_t            tail;
+    atomic_uint_least32_t    high_water;
+    atomic_uint_least32_t    overflow_total;
+} uni_net_udp_ring_t;
+
+
+
+//
+// Functions
+//
+
+/**
+ * Allocate a ring with the given capacity (rounded up to a power of two).
+ * @return ring pointer or NULL on allocation failure
+ */
+uni_net_udp_ring_t* uni_net_udp_ring_create(size_t capacity);
+
+/**
+ * Free the ring. Items still queued are not released; drain the ring first.
+ */
+void uni_net_udp_ring_delete(uni_net_udp_ring_t* ring);
+
+/**
+ * Enqueue one item. Safe for concurrent producers.
+ * @return false if the ring is full (overflow counter is incremented)
+ */
+bool uni_net_udp_ring_push(uni_net_udp_ring_t* ring, const uni_net_udp_ring_item_t* item);
+
+/**
+ * Dequeue one item. Safe for concurrent consumers.
+ * @return false if the ring is empty
+ */
+bool uni_net_udp_ring_pop(uni_net_udp_ring_t* ring, uni_net_udp_ring_item_t* item);
+
+/**
+ * Approximate number of queued items.
+ */
+size_t uni_net_udp_ring_depth(const uni_net_udp_ring_t* ring);
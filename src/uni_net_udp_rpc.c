@@ -0,0 +1,626 @@
+// SPDX-License-Identifier: MIT
+
+//
+// Includes
+//
+
+// stdlib
+#include <string.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+// FreeRTOS+TCP
+#include <FreeRTOS_IP.h>
+#include <FreeRTOS_Sockets.h>
+
+// Uni.Common
+#include "uni_common_math.h"
+
+// Uni.Net
+#include "uni_net_udp_rpc.h"
+
+
+
+//
+// Defines
+//
+
+#define UNI_NET_UDP_RPC_NONE            (-1)
+#define UNI_NET_UDP_RPC_ALLOC_TIMEOUT   (0U)
+
+#define UNI_NET_UDP_RPC_TICKS(ms)       (uni_common_math_max(pdMS_TO_TICKS(ms), (TickType_t)1U))
+#define UNI_NET_UDP_RPC_WHEEL_TICKS     UNI_NET_UDP_RPC_TICKS(UNI_NET_UDP_RPC_WHEEL_TICK_MS)
+
+
+
+//
+// Private
+//
+
+static inline void _lock(uni_net_udp_rpc_context_t* ctx) {
+    (void)xSemaphoreTake(ctx->state.lock, portMAX_DELAY);
+}
+
+static inline void _unlock(uni_net_udp_rpc_context_t* ctx) {
+    (void)xSemaphoreGive(ctx->state.lock);
+}
+
+static inline bool _time_reached(TickType_t now, TickType_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static inline bool _endpoint_equal(const uni_net_udp_endpoint_t* a, const uni_net_udp_endpoint_t* b) {
+    return a->addr == b->addr && a->port == b->port;
+}
+
+
+// Wire header
+static void _header_write(uint8_t* buf, uni_net_udp_rpc_type_e type, uint32_t id) {
+    buf[0] = UNI_NET_UDP_RPC_VERSION;
+    buf[1] = (uint8_t)type;
+    buf[2] = 0U;
+    buf[3] = 0U;
+    buf[4] = (uint8_t)(id >> 24U);
+    buf[5] = (uint8_t)(id >> 16U);
+    buf[6] = (uint8_t)(id >> 8U);
+    buf[7] = (uint8_t)id;
+}
+
+static bool _header_read(const uint8_t* buf, size_t length, uni_net_udp_rpc_type_e* type, uint32_t* id) {
+    if (length < UNI_NET_UDP_RPC_HEADER_SIZE || buf[0] != UNI_NET_UDP_RPC_VERSION) {
+        return false;
+    }
+    *type = (uni_net_udp_rpc_type_e)buf[1];
+    *id = ((uint32_t)buf[4] << 24U) | ((uint32_t)buf[5] << 16U) | ((uint32_t)buf[6] << 8U) | (uint32_t)buf[7];
+    return true;
+}
+
+static bool _transmit(uni_net_udp_rpc_context_t* ctx, const uni_net_udp_endpoint_t* to, uni_net_udp_rpc_type_e type, uint32_t id,
+                      const uint8_t* payload, size_t length) {
+    uni_net_udp_tx_item_t item = { 0 };
+    item.to = *to;
+    item.length = UNI_NET_UDP_RPC_HEADER_SIZE + length;
+    item.payload = uni_net_udp_payload_alloc(item.length, UNI_NET_UDP_RPC_ALLOC_TIMEOUT);
+    if (item.payload == nullptr) {
+        return false;
+    }
+
+    _header_write(item.payload, type, id);
+    if (length > 0U) {
+        memcpy(&item.payload[UNI_NET_UDP_RPC_HEADER_SIZE], payload, length);
+    }
+    return uni_net_udp_client_sendto_batch(&ctx->state.client, &item, 1U) == 1;
+}
+
+
+// RTT estimation (RFC 6298), all values in ticks
+static void _rtt_sample(uni_net_udp_rpc_state_t* state, TickType_t rtt) {
+    if (!state->rtt_valid) {
+        state->srtt = rtt;
+        state->rttvar = rtt / 2U;
+        state->rtt_valid = true;
+    } else {
+        const TickType_t delta = (state->srtt > rtt) ? (state->srtt - rtt) : (rtt - state->srtt);
+        state->rttvar = (3U * state->rttvar + delta) / 4U;
+        state->srtt = (7U * state->srtt + rtt) / 8U;
+    }
+
+    const TickType_t rto = state->srtt + uni_common_math_max(4U * state->rttvar, (TickType_t)1U);
+    state->rto = uni_common_math_min(uni_common_math_max(rto, UNI_NET_UDP_RPC_TICKS(UNI_NET_UDP_RPC_RTO_MIN_MS)), UNI_NET_UDP_RPC_TICKS(UNI_NET_UDP_RPC_RTO_MAX_MS));
+}
+
+
+// Timer wheel: doubly linked lists of pending slots, hashed by the slot boundary at or after the expiry tick
+static inline TickType_t _wheel_boundary(TickType_t tick) {
+    return ((tick + UNI_NET_UDP_RPC_WHEEL_TICKS - 1U) / UNI_NET_UDP_RPC_WHEEL_TICKS) * UNI_NET_UDP_RPC_WHEEL_TICKS;
+}
+
+static inline uint32_t _wheel_slot(TickType_t expires) {
+    // Every request of a slot is due once the cursor reaches its boundary, none waits a revolution
+    return (uint32_t)((_wheel_boundary(expires) / UNI_NET_UDP_RPC_WHEEL_TICKS) % UNI_NET_UDP_RPC_WHEEL_SLOTS);
+}
+
+static void _wheel_insert(uni_net_udp_rpc_state_t* state, int16_t index) {
+    uni_net_udp_rpc_pending_t* entry = &state->pending[index];
+    // Never hash behind the cursor, the slot would only be visited a full revolution later
+    if (!_time_reached(entry->expires, state->wheel_now)) {
+        entry->expires = state->wheel_now;
+    }
+    const uint32_t slot = _wheel_slot(entry->expires);
+
+    entry->wheel_prev = UNI_NET_UDP_RPC_NONE;
+    entry->wheel_next = state->wheel[slot];
+    if (entry->wheel_next != UNI_NET_UDP_RPC_NONE) {
+        state->pending[entry->wheel_next].wheel_prev = index;
+    }
+    state->wheel[slot] = index;
+}
+
+static void _wheel_remove(uni_net_udp_rpc_state_t* state, int16_t index) {
+    uni_net_udp_rpc_pending_t* entry = &state->pending[index];
+
+    if (entry->wheel_prev != UNI_NET_UDP_RPC_NONE) {
+        state->pending[entry->wheel_prev].wheel_next = entry->wheel_next;
+    } else {
+        state->wheel[_wheel_slot(entry->expires)] = entry->wheel_next;
+    }
+    if (entry->wheel_next != UNI_NET_UDP_RPC_NONE) {
+        state->pending[entry->wheel_next].wheel_prev = entry->wheel_prev;
+    }
+    entry->wheel_prev = UNI_NET_UDP_RPC_NONE;
+    entry->wheel_next = UNI_NET_UDP_RPC_NONE;
+}
+
+static int16_t _pending_find(const uni_net_udp_rpc_state_t* state, uint32_t id) {
+    for (int16_t i = 0; i < (int16_t)UNI_NET_UDP_RPC_MAX_PENDING; i++) {
+        if (state->pending[i].used && state->pending[i].id == id) {
+            return i;
+        }
+    }
+    return UNI_NET_UDP_RPC_NONE;
+}
+
+static uint32_t _next_id(uni_net_udp_rpc_state_t* state) {
+    uint32_t id = 0U;
+    do {
+        id = state->next_id++;
+    } while (id == 0U || _pending_find(state, id) != UNI_NET_UDP_RPC_NONE);
+    return id;
+}
+
+/**
+ * Retransmit or expire one due request. Runs under the lock: the caller may release the request
+ * payload as soon as its completion callback returned, so it is only read while the slot is owned.
+ * Returns true when the request ran out of retries and was removed into *expired.
+ */
+static bool _wheel_expire(uni_net_udp_rpc_context_t* ctx, int16_t index, TickType_t now, uni_net_udp_rpc_pending_t* expired) {
+    uni_net_udp_rpc_state_t* state = &ctx->state;
+    uni_net_udp_rpc_pending_t* entry = &state->pending[index];
+
+    _wheel_remove(state, index);
+    if (entry->retries >= ctx->config.max_retries) {
+        *expired = *entry;
+        entry->used = false;
+        state->stats.timeouts++;
+        return true;
+    }
+
+    entry->retries++;
+    entry->retransmitted = true;
+    entry->rto = uni_common_math_min(entry->rto * 2U, UNI_NET_UDP_RPC_TICKS(UNI_NET_UDP_RPC_RTO_MAX_MS));
+    entry->sent_at = now;
+    entry->expires = now + entry->rto;
+    _wheel_insert(state, index);
+    state->stats.retransmits++;
+
+    // A failed allocation is treated as a lost datagram and retried on the next expiry
+    (void)_transmit(ctx, &entry->remote, UNI_NET_UDP_RPC_TYPE_REQUEST, entry->id, entry->payload, entry->length);
+    return false;
+}
+
+/**
+ * Fire the due requests and arm the next wakeup.
+ * @return ticks until the earliest pending request is due, portMAX_DELAY with none pending
+ */
+static TickType_t _wheel_advance(uni_net_udp_rpc_context_t* ctx) {
+    uni_net_udp_rpc_state_t* state = &ctx->state;
+    uni_net_udp_rpc_pending_t expired[UNI_NET_UDP_RPC_MAX_PENDING];
+    size_t expired_count = 0U;
+
+    _lock(ctx);
+    const TickType_t now = xTaskGetTickCount();
+    for (uint32_t step = 0; step < UNI_NET_UDP_RPC_WHEEL_SLOTS && _time_reached(now, state->wheel_now); step++) {
+        int16_t index = state->wheel[_wheel_slot(state->wheel_now)];
+        while (index != UNI_NET_UDP_RPC_NONE) {
+            const int16_t next = state->pending[index].wheel_next;
+            // Slots also hold requests due in later wheel revolutions
+            if (_time_reached(now, state->pending[index].expires)
+                && _wheel_expire(ctx, index, now, &expired[expired_count])) {
+                expired_count++;
+            }
+            index = next;
+        }
+        state->wheel_now += UNI_NET_UDP_RPC_WHEEL_TICKS;
+    }
+    if (_time_reached(now, state->wheel_now)) {
+        // Fell more than a full revolution behind: every slot was visited once, resynchronize
+        state->wheel_now = _wheel_boundary(now + 1U);
+    }
+
+    // Sleep until the slot of the earliest request, indefinitely when idle
+    bool pending = false;
+    TickType_t earliest = 0U;
+    for (uint32_t i = 0; i < UNI_NET_UDP_RPC_MAX_PENDING; i++) {
+        if (state->pending[i].used && (!pending || !_time_reached(state->pending[i].expires, earliest))) {
+            earliest = state->pending[i].expires;
+            pending = true;
+        }
+    }
+    TickType_t wait = portMAX_DELAY;
+    if (pending) {
+        state->wheel_wake = _wheel_boundary(earliest);
+        wait = _time_reached(now, state->wheel_wake) ? 1U : (state->wheel_wake - now);
+    } else {
+        // Nothing to visit: keep the cursor at the present so a new request never waits for a catch-up
+        state->wheel_now = _wheel_boundary(now + 1U);
+    }
+    state->wheel_armed = pending;
+    _unlock(ctx);
+
+    for (size_t i = 0; i < expired_count; i++) {
+        expired[i].on_complete(expired[i].user, expired[i].id, UNI_NET_UDP_RPC_STATUS_TIMEOUT, nullptr, 0U);
+    }
+    return wait;
+}
+
+static void _uni_net_udp_rpc_task(void* arg) {
+    uni_net_udp_rpc_context_t* ctx = (uni_net_udp_rpc_context_t*)arg;
+
+    TickType_t wait = portMAX_DELAY;
+    while (!ctx->state.stop_requested) {
+        // A request due earlier than the armed wakeup and deinit cut the sleep short with a notification
+        (void)ulTaskNotifyTake(pdTRUE, wait);
+        if (!ctx->state.stop_requested) {
+            wait = _wheel_advance(ctx);
+        }
+    }
+
+    // Task exit, uni_net_udp_rpc_deinit() joins on the semaphore
+    ctx->state.task = nullptr;
+    (void)xSemaphoreGive(ctx->state.exited);
+    vTaskDelete(nullptr);
+}
+
+
+// Responder side
+static uni_net_udp_rpc_dedup_t* _dedup_find(uni_net_udp_rpc_state_t* state, const uni_net_udp_endpoint_t* peer, uint32_t id) {
+    for (uint32_t i = 0; i < UNI_NET_UDP_RPC_DEDUP_SLOTS; i++) {
+        uni_net_udp_rpc_dedup_t* entry = &state->dedup[i];
+        if (entry->used && entry->id == id && _endpoint_equal(&entry->peer, peer)) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+static void _dedup_forget(uni_net_udp_rpc_context_t* ctx, const uni_net_udp_endpoint_t* peer, uint32_t id) {
+    _lock(ctx);
+    uni_net_udp_rpc_dedup_t* entry = _dedup_find(&ctx->state, peer, id);
+    if (entry != nullptr) {
+        entry->used = false;
+    }
+    _unlock(ctx);
+}
+
+static void _handle_request(uni_net_udp_rpc_context_t* ctx, uint32_t id, const uint8_t* body, size_t length, const uni_net_udp_endpoint_t* from) {
+    uni_net_udp_rpc_state_t* state = &ctx->state;
+    uint8_t replay[UNI_NET_UDP_RPC_DEDUP_PAYLOAD];
+    size_t replay_length = 0U;
+    bool duplicate = false;
+
+    _lock(ctx);
+    uni_net_udp_rpc_dedup_t* entry = _dedup_find(state, from, id);
+    if (entry != nullptr) {
+        // Retransmitted request: replay the cached response, or drop while the first copy is being served
+        duplicate = true;
+        state->stats.duplicates++;
+        if (entry->cached) {
+            replay_length = entry->length;
+            memcpy(replay, entry->response, replay_length);
+        }
+    } else {
+        entry = &state->dedup[state->dedup_next];
+        state->dedup_next = (state->dedup_next + 1U) % UNI_NET_UDP_RPC_DEDUP_SLOTS;
+        entry->peer = *from;
+        entry->id = id;
+        entry->length = 0U;
+        entry->cached = false;
+        entry->used = true;
+    }
+    _unlock(ctx);
+
+    if (duplicate) {
+        if (replay_length > 0U) {
+            (void)_transmit(ctx, from, UNI_NET_UDP_RPC_TYPE_RESPONSE, id, replay, replay_length);
+        }
+        return;
+    }
+
+    // Never wait for a buffer on the receive task: without one the request is treated as lost
+    uni_net_udp_tx_item_t item = { 0 };
+    item.to = *from;
+    item.payload = uni_net_udp_payload_alloc(UNI_NET_UDP_RPC_DATAGRAM_MAX, UNI_NET_UDP_RPC_ALLOC_TIMEOUT);
+    if (item.payload == nullptr) {
+        _dedup_forget(ctx, from, id);
+        return;
+    }
+
+    uint8_t* response = &item.payload[UNI_NET_UDP_RPC_HEADER_SIZE];
+    const size_t response_length = ctx->config.on_request(ctx->config.user, body, length, from, response,
+                                                          UNI_NET_UDP_RPC_DATAGRAM_MAX - UNI_NET_UDP_RPC_HEADER_SIZE);
+    if (response_length == 0U || response_length > UNI_NET_UDP_RPC_DATAGRAM_MAX - UNI_NET_UDP_RPC_HEADER_SIZE) {
+        uni_net_udp_payload_release(item.payload);
+        return;
+    }
+
+    if (response_length <= UNI_NET_UDP_RPC_DEDUP_PAYLOAD) {
+        _lock(ctx);
+        // The slot may have been recycled by a burst of other requests meanwhile
+        entry = _dedup_find(state, from, id);
+        if (entry != nullptr) {
+            memcpy(entry->response, response, response_length);
+            entry->length = (uint16_t)response_length;
+            entry->cached = true;
+        }
+        _unlock(ctx);
+    } else {
+        // Too large to replay: a retransmission must reach the handler again instead of being dropped
+        _dedup_forget(ctx, from, id);
+    }
+
+    _header_write(item.payload, UNI_NET_UDP_RPC_TYPE_RESPONSE, id);
+    item.length = UNI_NET_UDP_RPC_HEADER_SIZE + response_length;
+    (void)uni_net_udp_client_sendto_batch(&ctx->state.client, &item, 1U);
+}
+
+
+// Requester side
+static void _handle_response(uni_net_udp_rpc_context_t* ctx, uint32_t id, const uint8_t* body, size_t length, const uni_net_udp_endpoint_t* from) {
+    uni_net_udp_rpc_state_t* state = &ctx->state;
+    uni_net_udp_rpc_complete_cb on_complete = nullptr;
+    void* user = nullptr;
+
+    _lock(ctx);
+    const int16_t index = _pending_find(state, id);
+    if (index != UNI_NET_UDP_RPC_NONE && _endpoint_equal(&state->pending[index].remote, from)) {
+        uni_net_udp_rpc_pending_t* entry = &state->pending[index];
+        // Karn's algorithm: a response to a retransmitted request is ambiguous, do not sample it
+        if (!entry->retransmitted) {
+            _rtt_sample(state, xTaskGetTickCount() - entry->sent_at);
+        }
+        _wheel_remove(state, index);
+        on_complete = entry->on_complete;
+        user = entry->user;
+        entry->used = false;
+    } else {
+        state->stats.duplicates++;
+    }
+    _unlock(ctx);
+
+    if (on_complete != nullptr) {
+        on_complete(user, id, UNI_NET_UDP_RPC_STATUS_OK, body, length);
+    }
+}
+
+static void _on_datagram(void* user, const uint8_t* payload, size_t length, const uni_net_udp_endpoint_t* from) {
+    uni_net_udp_rpc_context_t* ctx = (uni_net_udp_rpc_context_t*)user;
+    uni_net_udp_rpc_type_e type = UNI_NET_UDP_RPC_TYPE_REQUEST;
+    uint32_t id = 0U;
+
+    if (!_header_read(payload, length, &type, &id)) {
+        return;
+    }
+
+    const uint8_t* body = &payload[UNI_NET_UDP_RPC_HEADER_SIZE];
+    const size_t body_length = length - UNI_NET_UDP_RPC_HEADER_SIZE;
+    if (type == UNI_NET_UDP_RPC_TYPE_REQUEST && ctx->config.on_request != nullptr) {
+        _handle_request(ctx, id, body, body_length, from);
+    } else if (type == UNI_NET_UDP_RPC_TYPE_RESPONSE) {
+        _handle_response(ctx, id, body, body_length, from);
+    }
+}
+
+static void _resources_delete(uni_net_udp_rpc_context_t* ctx) {
+    if (ctx->state.lock != nullptr) {
+        vSemaphoreDelete(ctx->state.lock);
+        ctx->state.lock = nullptr;
+    }
+    if (ctx->state.exited != nullptr) {
+        vSemaphoreDelete(ctx->state.exited);
+        ctx->state.exited = nullptr;
+    }
+}
+
+static void _cancel_all(uni_net_udp_rpc_context_t* ctx) {
+    uni_net_udp_rpc_pending_t cancelled[UNI_NET_UDP_RPC_MAX_PENDING];
+    size_t count = 0U;
+
+    _lock(ctx);
+    for (int16_t i = 0; i < (int16_t)UNI_NET_UDP_RPC_MAX_PENDING; i++) {
+        if (ctx->state.pending[i].used) {
+            _wheel_remove(&ctx->state, i);
+            cancelled[count++] = ctx->state.pending[i];
+            ctx->state.pending[i].used = false;
+        }
+    }
+    _unlock(ctx);
+
+    for (size_t i = 0; i < count; i++) {
+        cancelled[i].on_complete(cancelled[i].user, cancelled[i].id, UNI_NET_UDP_RPC_STATUS_CANCELLED, nullptr, 0U);
+    }
+}
+
+
+
+//
+// Public
+//
+
+bool uni_net_udp_rpc_init(uni_net_udp_rpc_context_t* ctx, const uni_net_udp_rpc_config_t* cfg) {
+    if (ctx == nullptr || cfg == nullptr) {
+        return false;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->config = *cfg;
+    if (ctx->config.max_retries == 0U) {
+        ctx->config.max_retries = UNI_NET_UDP_RPC_MAX_RETRIES;
+    }
+    ctx->config.max_retries = uni_common_math_min(ctx->config.max_retries, (uint32_t)UINT8_MAX);
+    if (ctx->config.task_priority == 0U) {
+        ctx->config.task_priority = UNI_NET_UDP_RPC_TASK_PRIORITY;
+    }
+    if (ctx->config.task_stack_words == 0U) {
+        ctx->config.task_stack_words = UNI_NET_UDP_RPC_TASK_STACK_WORDS;
+    }
+
+    for (uint32_t i = 0; i < UNI_NET_UDP_RPC_MAX_PENDING; i++) {
+        ctx->state.pending[i].wheel_prev = UNI_NET_UDP_RPC_NONE;
+        ctx->state.pending[i].wheel_next = UNI_NET_UDP_RPC_NONE;
+    }
+    for (uint32_t i = 0; i < UNI_NET_UDP_RPC_WHEEL_SLOTS; i++) {
+        ctx->state.wheel[i] = UNI_NET_UDP_RPC_NONE;
+    }
+    ctx->state.rto = UNI_NET_UDP_RPC_TICKS(UNI_NET_UDP_RPC_RTO_INITIAL_MS);
+    ctx->state.wheel_now = _wheel_boundary(xTaskGetTickCount() + 1U);
+    (void)xApplicationGetRandomNumber(&ctx->state.next_id);
+
+    ctx->state.lock = xSemaphoreCreateMutex();
+    ctx->state.exited = xSemaphoreCreateBinary();
+    if (ctx->state.lock == nullptr || ctx->state.exited == nullptr) {
+        _resources_delete(ctx);
+        return false;
+    }
+
+    uni_net_udp_client_config_t client_cfg = {
+        .rx_timeout_ms    = UNI_NET_UDP_DEFAULT_RX_TIMEOUT_MS,
+        .tx_timeout_ms    = UNI_NET_UDP_DEFAULT_TX_TIMEOUT_MS,
+        .bind_port        = ctx->config.bind_port,
+        .on_receive       = _on_datagram,
+        .user             = ctx,
+        .task_priority    = ctx->config.task_priority,
+        .task_stack_words = ctx->config.task_stack_words,
+    };
+    if (!uni_net_udp_client_init(&ctx->state.client, &client_cfg)) {
+        _resources_delete(ctx);
+        return false;
+    }
+
+    if (xTaskCreate(_uni_net_udp_rpc_task, "UNI_NET_UDP_RPC", ctx->config.task_stack_words, ctx,
+                    ctx->config.task_priority, &ctx->state.task) != pdTRUE) {
+        (void)uni_net_udp_client_deinit(&ctx->state.client);
+        _resources_delete(ctx);
+        return false;
+    }
+
+    ctx->state.initialized = true;
+    return true;
+}
+
+bool uni_net_udp_rpc_deinit(uni_net_udp_rpc_context_t* ctx) {
+    if (ctx == nullptr || !ctx->state.initialized) {
+        return false;
+    }
+
+    ctx->state.initialized = false;
+    ctx->state.stop_requested = true;
+    if (ctx->state.task != nullptr) {
+        (void)xTaskNotifyGive(ctx->state.task);
+    }
+    (void)xSemaphoreTake(ctx->state.exited, portMAX_DELAY);
+
+    // Stops the receive task: no completion can race with the cancellation below
+    (void)uni_net_udp_client_deinit(&ctx->state.client);
+    _cancel_all(ctx);
+
+    _resources_delete(ctx);
+    memset(ctx, 0, sizeof(*ctx));
+    return true;
+}
+
+bool uni_net_udp_rpc_call(uni_net_udp_rpc_context_t* ctx, const uni_net_udp_endpoint_t* to, const uint8_t* payload, size_t length,
+                          uni_net_udp_rpc_complete_cb on_complete, void* user, uint32_t* out_id) {
+    if (ctx == nullptr || !ctx->state.initialized || to == nullptr || on_complete == nullptr
+        || (payload == nullptr && length > 0U) || length > UNI_NET_UDP_RPC_DATAGRAM_MAX - UNI_NET_UDP_RPC_HEADER_SIZE) {
+        return false;
+    }
+
+    uni_net_udp_rpc_state_t* state = &ctx->state;
+    bool result = false;
+
+    _lock(ctx);
+    for (int16_t i = 0; i < (int16_t)UNI_NET_UDP_RPC_MAX_PENDING; i++) {
+        uni_net_udp_rpc_pending_t* entry = &state->pending[i];
+        if (entry->used) {
+            continue;
+        }
+
+        const TickType_t now = xTaskGetTickCount();
+        entry->id = _next_id(state);
+        entry->remote = *to;
+        entry->payload = payload;
+        entry->length = length;
+        entry->on_complete = on_complete;
+        entry->user = user;
+        entry->rto = state->rto;
+        entry->sent_at = now;
+        entry->expires = now + entry->rto;
+        entry->retries = 0U;
+        entry->retransmitted = false;
+        entry->used = true;
+        _wheel_insert(state, i);
+        state->stats.requests++;
+
+        // Rearm the timer task when it sleeps past this request
+        if (!state->wheel_armed || !_time_reached(entry->expires, state->wheel_wake)) {
+            state->wheel_armed = true;
+            state->wheel_wake = _wheel_boundary(entry->expires);
+            if (state->task != nullptr) {
+                (void)xTaskNotifyGive(state->task);
+            }
+        }
+
+        if (out_id != nullptr) {
+            *out_id = entry->id;
+        }
+
+        // Sent under the lock so a fast response always finds its slot; a lost first copy is retransmitted
+        (void)_transmit(ctx, to, UNI_NET_UDP_RPC_TYPE_REQUEST, entry->id, payload, length);
+        result = true;
+        break;
+    }
+    _unlock(ctx);
+
+    return result;
+}
+
+bool uni_net_udp_rpc_cancel(uni_net_udp_rpc_context_t* ctx, uint32_t id) {
+    if (ctx == nullptr || !ctx->state.initialized) {
+        return false;
+    }
+
+    uni_net_udp_rpc_pending_t cancelled = { 0 };
+    bool found = false;
+
+    _lock(ctx);
+    const int16_t index = _pending_find(&ctx->state, id);
+    if (index != UNI_NET_UDP_RPC_NONE) {
+        _wheel_remove(&ctx->state, index);
+        cancelled = ctx->state.pending[index];
+        ctx->state.pending[index].used = false;
+        found = true;
+    }
+    _unlock(ctx);
+
+    if (found) {
+        cancelled.on_complete(cancelled.user, cancelled.id, UNI_NET_UDP_RPC_STATUS_CANCELLED, nullptr, 0U);
+    }
+    return found;
+}
+
+bool uni_net_udp_rpc_get_stats(const uni_net_udp_rpc_context_t* ctx, uni_net_udp_rpc_stats_t* out_stats) {
+    if (ctx == nullptr || out_stats == nullptr || !ctx->state.initialized) {
+        return false;
+    }
+
+    uni_net_udp_rpc_context_t* mutable_ctx = (uni_net_udp_rpc_context_t*)ctx;
+    _lock(mutable_ctx);
+    *out_stats = ctx->state.stats;
+    out_stats->rto_ms = (uint32_t)(ctx->state.rto * portTICK_PERIOD_MS);
+    out_stats->srtt_ms = ctx->state.rtt_valid ? (uint32_t)(ctx->state.srtt * portTICK_PERIOD_MS) : 0U;
+    _unlock(mutable_ctx);
+    return true;
+}
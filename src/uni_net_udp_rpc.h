@@ -0,0 +1,268 @@
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+// Uni.NET
+#include "uni_net_udp_client.h"
+
+
+//
+// Defaults and configuration
+//
+
+/**
+ * Wire header prepended to every RPC datagram:
+ *  - byte 0   : protocol version (UNI_NET_UDP_RPC_VERSION)
+ *  - byte 1   : message type (uni_net_udp_rpc_type_e)
+ *  - byte 2-3 : reserved, zero
+ *  - byte 4-7 : request ID, big endian
+ */
+#define UNI_NET_UDP_RPC_HEADER_SIZE         (8U)
+#define UNI_NET_UDP_RPC_VERSION             (1U)
+
+/**
+ * Largest RPC datagram (header included), one Ethernet MTU worth of UDP payload.
+ */
+#ifndef UNI_NET_UDP_RPC_DATAGRAM_MAX
+#define UNI_NET_UDP_RPC_DATAGRAM_MAX        (1472U)
+#endif
+
+/**
+ * Maximum number of requests in flight per RPC context.
+ */
+#ifndef UNI_NET_UDP_RPC_MAX_PENDING
+#define UNI_NET_UDP_RPC_MAX_PENDING         (16U)
+#endif
+
+/**
+ * Timer wheel geometry: slot count and slot granularity.
+ */
+#ifndef UNI_NET_UDP_RPC_WHEEL_SLOTS
+#define UNI_NET_UDP_RPC_WHEEL_SLOTS         (32U)
+#endif
+
+#ifndef UNI_NET_UDP_RPC_WHEEL_TICK_MS
+#define UNI_NET_UDP_RPC_WHEEL_TICK_MS       (10U)
+#endif
+
+/**
+ * Retransmission timeout bounds, RTO before the first RTT sample and default retry count.
+ */
+#ifndef UNI_NET_UDP_RPC_RTO_INITIAL_MS
+#define UNI_NET_UDP_RPC_RTO_INITIAL_MS      (250U)
+#endif
+
+#ifndef UNI_NET_UDP_RPC_RTO_MIN_MS
+#define UNI_NET_UDP_RPC_RTO_MIN_MS          (20U)
+#endif
+
+#ifndef UNI_NET_UDP_RPC_RTO_MAX_MS
+#define UNI_NET_UDP_RPC_RTO_MAX_MS          (4000U)
+#endif
+
+#ifndef UNI_NET_UDP_RPC_MAX_RETRIES
+#define UNI_NET_UDP_RPC_MAX_RETRIES         (4U)
+#endif
+
+/**
+ * Responder duplicate suppression: number of remembered (peer, request ID) pairs and the largest
+ * response kept for replay to a retransmitted request. Larger responses are not remembered, so a
+ * retransmission of their request reaches the handler again.
+ */
+#ifndef UNI_NET_UDP_RPC_DEDUP_SLOTS
+#define UNI_NET_UDP_RPC_DEDUP_SLOTS         (8U)
+#endif
+
+#ifndef UNI_NET_UDP_RPC_DEDUP_PAYLOAD
+#define UNI_NET_UDP_RPC_DEDUP_PAYLOAD       (128U)
+#endif
+
+#ifndef UNI_NET_UDP_RPC_TASK_STACK_WORDS
+#define UNI_NET_UDP_RPC_TASK_STACK_WORDS    (configMINIMAL_STACK_SIZE * 2U)
+#endif
+
+#ifndef UNI_NET_UDP_RPC_TASK_PRIORITY
+#define UNI_NET_UDP_RPC_TASK_PRIORITY       (2U)
+#endif
+
+
+//
+// Typedefs
+//
+
+typedef enum {
+    UNI_NET_UDP_RPC_TYPE_REQUEST  = 1,
+    UNI_NET_UDP_RPC_TYPE_RESPONSE = 2,
+} uni_net_udp_rpc_type_e;
+
+typedef enum {
+    UNI_NET_UDP_RPC_STATUS_OK        = 0, /* Response received, payload/length describe it */
+    UNI_NET_UDP_RPC_STATUS_TIMEOUT   = 1, /* No response after all retransmissions */
+    UNI_NET_UDP_RPC_STATUS_CANCELLED = 2, /* Cancelled by uni_net_udp_rpc_cancel() or deinit */
+} uni_net_udp_rpc_status_e;
+
+/**
+ * Completion callback of a request. Called exactly once per accepted request, from the client receive
+ * task (responses) or the RPC task (timeouts). payload is valid for the duration of the callback only.
+ */
+typedef void (*uni_net_udp_rpc_complete_cb)(void* user, uint32_t id, uni_net_udp_rpc_status_e status, const uint8_t* payload, size_t length);
+
+/**
+ * Request handler of the responder side. Called once per distinct (peer, request ID); retransmitted
+ * requests are answered from the duplicate cache without calling the handler again. Exceptions, where a
+ * retransmission calls the handler again: the response exceeded UNI_NET_UDP_RPC_DEDUP_PAYLOAD, or no
+ * network buffer was free for it (the handler was not called then). Handlers producing large responses
+ * must therefore be idempotent.
+ *
+ * Returns:
+ *  - number of response bytes written to response (0: no response is sent)
+ */
+typedef size_t (*uni_net_udp_rpc_request_cb)(void* user, const uint8_t* request, size_t length, const uni_net_udp_endpoint_t* from,
+                                             uint8_t* response, size_t response_size);
+
+typedef struct {
+    uint32_t                    id;
+    uni_net_udp_endpoint_t      remote;
+    const uint8_t*              payload;          /* Caller-owned, must stay valid until completion */
+    size_t                      length;
+    uni_net_udp_rpc_complete_cb on_complete;
+    void*                       user;
+    TickType_t                  sent_at;
+    TickType_t                  expires;
+    TickType_t                  rto;
+    uint8_t                     retries;
+    bool                        retransmitted;    /* Karn: no RTT sample from retransmitted requests */
+    bool                        used;
+    int16_t                     wheel_prev;
+    int16_t                     wheel_next;
+} uni_net_udp_rpc_pending_t;
+
+typedef struct {
+    uni_net_udp_endpoint_t      peer;
+    uint32_t                    id;
+    uint16_t                    length;
+    bool                        used;
+    bool                        cached;           /* response holds the reply to replay */
+    uint8_t                     response[UNI_NET_UDP_RPC_DEDUP_PAYLOAD];
+} uni_net_udp_rpc_dedup_t;
+
+typedef struct {
+    uint64_t                    requests;
+    uint64_t                    retransmits;
+    uint64_t                    timeouts;
+    uint64_t                    duplicates;       /* Duplicate requests suppressed and stray/duplicate responses dropped */
+    uint32_t                    rto_ms;           /* Current base retransmission timeout */
+    uint32_t                    srtt_ms;          /* Smoothed round-trip time, 0 before the first sample */
+} uni_net_udp_rpc_stats_t;
+
+
+//
+// Configuration, State, Context
+//
+
+typedef struct {
+    uint16_t                    bind_port;        /* Local port (host byte order), required for the responder side; 0 binds an ephemeral port */
+    uni_net_udp_rpc_request_cb  on_request;       /* Optional responder handler */
+    void*                       user;             /* User context pointer passed to on_request */
+    uint32_t                    max_retries;      /* Retransmissions per request, 0 for UNI_NET_UDP_RPC_MAX_RETRIES */
+    UBaseType_t                 task_priority;    /* Priority of the client receive task and RPC timer task, 0 for default */
+    uint32_t                    task_stack_words; /* Stack of both tasks in words, 0 for default */
+} uni_net_udp_rpc_config_t;
+
+typedef struct {
+    bool                        initialized;
+    volatile bool               stop_requested;
+    uni_net_udp_client_context_t client;
+    SemaphoreHandle_t           lock;
+    TaskHandle_t                task;
+    SemaphoreHandle_t           exited;           /* Given by the timer task on exit */
+    uint32_t                    next_id;
+
+    TickType_t                  srtt;
+    TickType_t                  rttvar;
+    TickType_t                  rto;
+    bool                        rtt_valid;
+
+    uni_net_udp_rpc_pending_t   pending[UNI_NET_UDP_RPC_MAX_PENDING];
+    int16_t                     wheel[UNI_NET_UDP_RPC_WHEEL_SLOTS];
+    TickType_t                  wheel_now;        /* Slot boundary the cursor visits next */
+    TickType_t                  wheel_wake;       /* Boundary the timer task sleeps until, while armed */
+    bool                        wheel_armed;      /* Timer task sleeps until wheel_wake, not indefinitely */
+
+    uni_net_udp_rpc_dedup_t     dedup[UNI_NET_UDP_RPC_DEDUP_SLOTS];
+    uint32_t                    dedup_next;
+
+    uni_net_udp_rpc_stats_t     stats;
+} uni_net_udp_rpc_state_t;
+
+typedef struct {
+    uni_net_udp_rpc_config_t    config;
+    uni_net_udp_rpc_state_t     state;
+} uni_net_udp_rpc_context_t;
+
+
+//
+// Public API
+//
+
+/**
+ * Initialize an RPC context: creates a UDP client in asynchronous receive mode (bound to bind_port, or
+ * to an ephemeral port when it is 0) and a timer task that drives retransmissions from a hashed timer
+ * wheel.
+ *
+ * Returns:
+ *  - true on success; false on invalid arguments or resource allocation failure.
+ */
+bool uni_net_udp_rpc_init(uni_net_udp_rpc_context_t* ctx, const uni_net_udp_rpc_config_t* cfg);
+
+/**
+ * Stop the RPC engine. Pending requests complete with UNI_NET_UDP_RPC_STATUS_CANCELLED.
+ */
+bool uni_net_udp_rpc_deinit(uni_net_udp_rpc_context_t* ctx);
+
+/**
+ * Send a request and return immediately. The request is retransmitted with an RTT-adaptive timeout
+ * (exponential backoff) until a response with the same ID arrives or retries are exhausted.
+ *
+ * Parameters:
+ *  - payload: request body without RPC header; must stay valid until on_complete is called.
+ *  - length: body length, at most UNI_NET_UDP_RPC_DATAGRAM_MAX - UNI_NET_UDP_RPC_HEADER_SIZE.
+ *  - out_id: optional, receives the request ID.
+ *
+ * Returns:
+ *  - true if the request was accepted; false on invalid arguments or when all pending slots are busy.
+ */
+bool uni_net_udp_rpc_call(uni_net_udp_rpc_context_t* ctx, const uni_net_udp_endpoint_t* to, const uint8_t* payload, size_t length,
+                          uni_net_udp_rpc_complete_cb on_complete, void* user, uint32_t* out_id);
+
+/**
+ * Cancel a pending request. Its completion callback is invoked with UNI_NET_UDP_RPC_STATUS_CANCELLED.
+ *
+ * Returns:
+ *  - true if the request was pending.
+ */
+bool uni_net_udp_rpc_cancel(uni_net_udp_rpc_context_t* ctx, uint32_t id);
+
+/**
+ * Get RPC counters and current RTT estimate.
+ */
+bool uni_net_udp_rpc_get_stats(const uni_net_udp_rpc_context_t* ctx, uni_net_udp_rpc_stats_t* out_stats);
+
+#if defined(__cplusplus)
+}
+#endif
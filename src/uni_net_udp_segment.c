@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: MIT
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdatomic.h>
+#include <string.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <task.h>
+
+// Uni.Common
+#include "uni_common_math.h"
+
+// Uni.Net
+#include "uni_net_udp_segment.h"
+
+
+
+//
+// Globals
+//
+
+// Shared by all senders: the receiver keys messages by (source, message ID)
+static atomic_uint_least32_t g_uni_net_udp_segment_message_id;
+
+
+
+//
+// Private
+//
+
+static inline void _put_be32(uint8_t* buf, uint32_t value) {
+    buf[0] = (uint8_t)(value >> 24U);
+    buf[1] = (uint8_t)(value >> 16U);
+    buf[2] = (uint8_t)(value >> 8U);
+    buf[3] = (uint8_t)value;
+}
+
+static inline uint32_t _get_be32(const uint8_t* buf) {
+    return ((uint32_t)buf[0] << 24U) | ((uint32_t)buf[1] << 16U) | ((uint32_t)buf[2] << 8U) | (uint32_t)buf[3];
+}
+
+static int32_t _send_chunk(uni_net_udp_segment_send_fn send, void* sender, uni_net_udp_tx_item_t* items, size_t count) {
+    const int32_t sent = send(sender, items, count);
+    if (sent < 0) {
+        // Rejected before any buffer was consumed
+        for (size_t i = 0; i < count; i++) {
+            uni_net_udp_payload_release(items[i].payload);
+        }
+        return sent;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (items[i].result <= 0) {
+            return items[i].result;
+        }
+    }
+    return 1;
+}
+
+static uni_net_udp_reasm_slot_t* _slot_get(uni_net_udp_reasm_context_t* ctx, const uni_net_udp_endpoint_t* from, uint32_t message_id) {
+    uni_net_udp_reasm_slot_t* victim = nullptr;
+
+    for (uint32_t i = 0; i < UNI_NET_UDP_REASM_SLOTS; i++) {
+        uni_net_udp_reasm_slot_t* slot = &ctx->state.slots[i];
+        if (!slot->used) {
+            if (victim == nullptr || victim->used) {
+                victim = slot;
+            }
+        } else if (slot->message_id == message_id && slot->from.addr == from->addr && slot->from.port == from->port) {
+            return slot;
+        } else if (victim == nullptr || (victim->used && (int32_t)(slot->started_at - victim->started_at) < 0)) {
+            victim = slot;
+        }
+    }
+
+    if (victim->used) {
+        // Table full: the oldest incomplete message goes, expired or not
+        ctx->state.stats.evicted++;
+    }
+
+    victim->used = true;
+    victim->from = *from;
+    victim->message_id = message_id;
+    victim->total = 0U;
+    victim->count = 0U;
+    victim->received = 0U;
+    victim->received_mask = 0U;
+    victim->started_at = xTaskGetTickCount();
+    return victim;
+}
+
+static void _expire(uni_net_udp_reasm_context_t* ctx) {
+    const TickType_t now = xTaskGetTickCount();
+    const TickType_t timeout = pdMS_TO_TICKS(ctx->config.timeout_ms);
+
+    for (uint32_t i = 0; i < UNI_NET_UDP_REASM_SLOTS; i++) {
+        uni_net_udp_reasm_slot_t* slot = &ctx->state.slots[i];
+        if (slot->used && (TickType_t)(now - slot->started_at) >= timeout) {
+            slot->used = false;
+            ctx->state.stats.evicted++;
+        }
+    }
+}
+
+
+
+//
+// Public
+//
+
+int32_t uni_net_udp_segment_send(uni_net_udp_segment_send_fn send, void* sender, const uni_net_udp_endpoint_t* to,
+                                 const uint8_t* buf, size_t len, uint32_t alloc_timeout_ms) {
+    if (send == nullptr || to == nullptr || buf == nullptr || len == 0U || len > INT32_MAX) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+
+    const size_t count = (len + UNI_NET_UDP_SEGMENT_PAYLOAD_MAX - 1U) / UNI_NET_UDP_SEGMENT_PAYLOAD_MAX;
+    if (count > UNI_NET_UDP_SEGMENT_COUNT_MAX || count > UINT8_MAX) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+
+    const uint32_t message_id = atomic_fetch_add_explicit(&g_uni_net_udp_segment_message_id, 1U, memory_order_relaxed);
+    uni_net_udp_tx_item_t items[UNI_NET_UDP_SEGMENT_TX_BATCH];
+    size_t index = 0U;
+
+    while (index < count) {
+        size_t chunk = 0U;
+        bool exhausted = false;
+
+        while (chunk < UNI_NET_UDP_SEGMENT_TX_BATCH && index < count) {
+            const size_t offset = index * UNI_NET_UDP_SEGMENT_PAYLOAD_MAX;
+            const size_t seg_len = uni_common_math_min(len - offset, (size_t)UNI_NET_UDP_SEGMENT_PAYLOAD_MAX);
+            uint8_t* payload = uni_net_udp_payload_alloc(UNI_NET_UDP_SEGMENT_HEADER_SIZE + seg_len, alloc_timeout_ms);
+            if (payload == nullptr) {
+                exhausted = true;
+                break;
+            }
+
+            payload[0] = UNI_NET_UDP_SEGMENT_VERSION;
+            payload[1] = (uint8_t)index;
+            payload[2] = (uint8_t)count;
+            payload[3] = 0U;
+            _put_be32(&payload[4], message_id);
+            _put_be32(&payload[8], (uint32_t)len);
+            memcpy(&payload[UNI_NET_UDP_SEGMENT_HEADER_SIZE], &buf[offset], seg_len);
+
+            items[chunk].to = *to;
+            items[chunk].payload = payload;
+            items[chunk].length = UNI_NET_UDP_SEGMENT_HEADER_SIZE + seg_len;
+            items[chunk].result = 0;
+            chunk++;
+            index++;
+        }
+
+        if (chunk > 0U) {
+            const int32_t rv = _send_chunk(send, sender, items, chunk);
+            if (rv <= 0) {
+                return rv;
+            }
+        }
+        if (exhausted) {
+            return UNI_NET_UDP_RET_TIMEOUT;
+        }
+    }
+
+    return (int32_t)len;
+}
+
+bool uni_net_udp_reasm_init(uni_net_udp_reasm_context_t* ctx, const uni_net_udp_reasm_config_t* cfg) {
+    if (ctx == nullptr) {
+        return false;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    if (cfg != nullptr) {
+        ctx->config = *cfg;
+    }
+    const uint32_t format_max = UNI_NET_UDP_SEGMENT_COUNT_MAX * UNI_NET_UDP_SEGMENT_PAYLOAD_MAX;
+    if (ctx->config.message_max == 0U || ctx->config.message_max > format_max) {
+        ctx->config.message_max = format_max;
+    }
+    if (ctx->config.timeout_ms == 0U) {
+        ctx->config.timeout_ms = UNI_NET_UDP_REASM_DEFAULT_TIMEOUT_MS;
+    }
+
+    ctx->state.storage = pvPortMalloc((size_t)UNI_NET_UDP_REASM_SLOTS * ctx->config.message_max);
+    if (ctx->state.storage == nullptr) {
+        return false;
+    }
+    for (uint32_t i = 0; i < UNI_NET_UDP_REASM_SLOTS; i++) {
+        ctx->state.slots[i].buffer = &ctx->state.storage[(size_t)i * ctx->config.message_max];
+    }
+
+    ctx->state.initialized = true;
+    return true;
+}
+
+bool uni_net_udp_reasm_deinit(uni_net_udp_reasm_context_t* ctx) {
+    if (ctx == nullptr || !ctx->state.initialized) {
+        return false;
+    }
+
+    vPortFree(ctx->state.storage);
+    memset(ctx, 0, sizeof(*ctx));
+    return true;
+}
+
+int32_t uni_net_udp_reasm_push(uni_net_udp_reasm_context_t* ctx, const uint8_t* datagram, size_t length,
+                               const uni_net_udp_endpoint_t* from, const uint8_t** out_message) {
+    if (ctx == nullptr || !ctx->state.initialized || datagram == nullptr || from == nullptr || out_message == nullptr) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+
+    // Non-last segments share one payload length; the last one ends exactly at total
+    bool valid = length > UNI_NET_UDP_SEGMENT_HEADER_SIZE && datagram[0] == UNI_NET_UDP_SEGMENT_VERSION;
+    const uint8_t index = valid ? datagram[1] : 0U;
+    const uint8_t count = valid ? datagram[2] : 0U;
+    const uint32_t message_id = valid ? _get_be32(&datagram[4]) : 0U;
+    const uint32_t total = valid ? _get_be32(&datagram[8]) : 0U;
+    const size_t seg_len = valid ? length - UNI_NET_UDP_SEGMENT_HEADER_SIZE : 0U;
+    size_t offset = 0U;
+
+    valid = valid && count > 0U && count <= UNI_NET_UDP_SEGMENT_COUNT_MAX && index < count
+            && total > 0U && total <= ctx->config.message_max;
+    if (valid) {
+        if (index + 1U < count) {
+            offset = (size_t)index * seg_len;
+            valid = (offset + seg_len < total) && ((size_t)count * seg_len >= total);
+        } else {
+            valid = (count == 1U) ? (seg_len == total) : (seg_len < total);
+            offset = valid ? total - seg_len : 0U;
+        }
+    }
+    if (!valid) {
+        ctx->state.stats.malformed++;
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+
+    _expire(ctx);
+    uni_net_udp_reasm_slot_t* slot = _slot_get(ctx, from, message_id);
+    if (slot->count == 0U) {
+        slot->count = count;
+        slot->total = total;
+    } else if (slot->count != count || slot->total != total) {
+        ctx->state.stats.malformed++;
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+
+    const uint64_t bit = 1ULL << index;
+    if ((slot->received_mask & bit) != 0U) {
+        ctx->state.stats.duplicates++;
+        return 0;
+    }
+
+    memcpy(&slot->buffer[offset], &datagram[UNI_NET_UDP_SEGMENT_HEADER_SIZE], seg_len);
+    slot->received_mask |= bit;
+    slot->received++;
+
+    if (slot->received < slot->count) {
+        return 0;
+    }
+
+    // Buffer content survives until the slot is reused by a later push
+    slot->used = false;
+    ctx->state.stats.completed++;
+    *out_message = slot->buffer;
+    return (int32_t)slot->total;
+}
+
+bool uni_net_udp_reasm_get_stats(const uni_net_udp_reasm_context_t* ctx, uni_net_udp_reasm_stats_t* out_stats) {
+    if (ctx == nullptr || out_stats == nullptr) {
+        return false;
+    }
+    *out_stats = ctx->state.stats;
+    return true;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+
+// Uni.NET
+#include "uni_net_udp_client.h"
+
+
+//
+// Defaults and configuration
+//
+
+/**
+ * Segment header prepended to every datagram of a large message:
+ *  - byte 0    : version (UNI_NET_UDP_SEGMENT_VERSION)
+ *  - byte 1    : segment index
+ *  - byte 2    : segment count
+ *  - byte 3    : reserved, zero
+ *  - byte 4-7  : message ID, big endian
+ *  - byte 8-11 : total message length, big endian
+ * All segments but the last carry the same payload length.
+ */
+#define UNI_NET_UDP_SEGMENT_HEADER_SIZE     (12U)
+#define UNI_NET_UDP_SEGMENT_VERSION         (1U)
+
+/**
+ * Largest segment datagram (header included), one Ethernet MTU worth of UDP payload.
+ */
+#ifndef UNI_NET_UDP_SEGMENT_DATAGRAM_MAX
+#define UNI_NET_UDP_SEGMENT_DATAGRAM_MAX    (1472U)
+#endif
+
+#define UNI_NET_UDP_SEGMENT_PAYLOAD_MAX     (UNI_NET_UDP_SEGMENT_DATAGRAM_MAX - UNI_NET_UDP_SEGMENT_HEADER_SIZE)
+
+/**
+ * Segments per message; bounds a message to UNI_NET_UDP_SEGMENT_COUNT_MAX * UNI_NET_UDP_SEGMENT_PAYLOAD_MAX bytes.
+ */
+#ifndef UNI_NET_UDP_SEGMENT_COUNT_MAX
+#define UNI_NET_UDP_SEGMENT_COUNT_MAX       (64U)
+#endif
+
+// Reassembly tracks the received segments of a message in a 64-bit mask
+_Static_assert(UNI_NET_UDP_SEGMENT_COUNT_MAX >= 1U && UNI_NET_UDP_SEGMENT_COUNT_MAX <= 64U,
+               "UNI_NET_UDP_SEGMENT_COUNT_MAX must be within 1..64");
+
+/**
+ * Segments handed to the stack per batch; keeps a large message from draining the network buffer pool.
+ */
+#ifndef UNI_NET_UDP_SEGMENT_TX_BATCH
+#define UNI_NET_UDP_SEGMENT_TX_BATCH        (8U)
+#endif
+
+/**
+ * Reassembly table defaults: concurrent messages in progress and the age after which an incomplete
+ * message may be evicted.
+ */
+#ifndef UNI_NET_UDP_REASM_SLOTS
+#define UNI_NET_UDP_REASM_SLOTS             (4U)
+#endif
+
+#ifndef UNI_NET_UDP_REASM_DEFAULT_TIMEOUT_MS
+#define UNI_NET_UDP_REASM_DEFAULT_TIMEOUT_MS (500U)
+#endif
+
+
+//
+// Segmentation
+//
+
+/**
+ * Transmit hook with the signature of uni_net_udp_{client,server}_sendto_batch().
+ */
+typedef int32_t (*uni_net_udp_segment_send_fn)(void* sender, uni_net_udp_tx_item_t* items, size_t count);
+
+/**
+ * Split buf into segments and send them through send, batch by batch. Each segment is copied once into
+ * a zero-copy network buffer. Used by uni_net_udp_{client,server}_sendto_large().
+ *
+ * Returns:
+ *  - > 0 : len, all segments queued
+ *  -   0 : no network buffer became available within alloc_timeout_ms (UNI_NET_UDP_RET_TIMEOUT)
+ *  - < 0 : -pdFREERTOS_ERRNO_EINVAL for invalid arguments or oversized messages, or the first stack error
+ * A message is only useful to the receiver if complete; on 0 or < 0 some segments may already be sent.
+ */
+int32_t uni_net_udp_segment_send(uni_net_udp_segment_send_fn send, void* sender, const uni_net_udp_endpoint_t* to,
+                                 const uint8_t* buf, size_t len, uint32_t alloc_timeout_ms);
+
+
+//
+// Reassembly
+//
+
+typedef struct {
+    uni_net_udp_endpoint_t from;
+    uint32_t               message_id;
+    uint32_t               total;
+    uint64_t               received_mask;   /* Bit i set when segment i arrived */
+    uint8_t                count;
+    uint8_t                received;
+    bool                   used;
+    TickType_t             started_at;
+    uint8_t*               buffer;          /* message_max bytes inside the context allocation */
+} uni_net_udp_reasm_slot_t;
+
+typedef struct {
+    uint64_t completed;
+    uint64_t duplicates;                    /* Segments already received */
+    uint64_t malformed;                     /* Bad header, inconsistent segment or message above message_max */
+    uint64_t evicted;                       /* Incomplete messages dropped to make room (expired or oldest) */
+} uni_net_udp_reasm_stats_t;
+
+typedef struct {
+    uint32_t message_max;                   /* Largest accepted message, 0 for the segment format maximum */
+    uint32_t timeout_ms;                    /* Incomplete message lifetime, 0 for UNI_NET_UDP_REASM_DEFAULT_TIMEOUT_MS */
+} uni_net_udp_reasm_config_t;
+
+typedef struct {
+    bool                      initialized;
+    uint8_t*                  storage;
+    uni_net_udp_reasm_slot_t  slots[UNI_NET_UDP_REASM_SLOTS];
+    uni_net_udp_reasm_stats_t stats;
+} uni_net_udp_reasm_state_t;
+
+typedef struct {
+    uni_net_udp_reasm_config_t config;
+    uni_net_udp_reasm_state_t  state;
+} uni_net_udp_reasm_context_t;
+
+/**
+ * Initialize a reassembly table. Allocates UNI_NET_UDP_REASM_SLOTS * message_max bytes from the FreeRTOS heap.
+ * The table is not thread-safe; feed it from a single receive path (e.g. the on_receive callback).
+ */
+bool uni_net_udp_reasm_init(uni_net_udp_reasm_context_t* ctx, const uni_net_udp_reasm_config_t* cfg);
+
+bool uni_net_udp_reasm_deinit(uni_net_udp_reasm_context_t* ctx);
+
+/**
+ * Feed one received datagram.
+ *
+ * Returns:
+ *  - > 0 : message complete, *out_message points to it and stays valid until the next push
+ *  -   0 : segment stored, message incomplete
+ *  - < 0 : -pdFREERTOS_ERRNO_EINVAL for datagrams that are not valid segments
+ */
+int32_t uni_net_udp_reasm_push(uni_net_udp_reasm_context_t* ctx, const uint8_t* datagram, size_t length,
+                               const uni_net_udp_endpoint_t* from, const uint8_t** out_message);
+
+bool uni_net_udp_reasm_get_stats(const uni_net_udp_reasm_context_t* ctx, uni_net_udp_reasm_stats_t* out_stats);
+
+#if defined(__cplusplus)
+}
+#endif
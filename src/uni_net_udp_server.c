@@ -22,36 +22,39 @@
 
 // Uni.NET
 #include "uni_net_udp_server.h"
+#include "uni_net_udp_batch.h"
+#include "uni_net_udp_coalesce.h"
+#include "uni_net_udp_igmp.h"
+#include "uni_net_udp_ring.h"
+#include "uni_net_udp_segment.h"
+#include "uni_net_udp_stats.h"
 
 #include "uni_common_bytes.h"
+#include "uni_common_math.h"
 
 
 //
 // Local configuration
 //
 
-#ifndef UNI_NET_UDP_SERVER_RX_BATCH_DEPTH
-#define UNI_NET_UDP_SERVER_RX_BATCH_DEPTH           (8U)
+#ifndef UNI_NET_UDP_SERVER_RX_QUEUE_PACKETS
+#define UNI_NET_UDP_SERVER_RX_QUEUE_PACKETS         (64U)
 #endif
 
-#ifndef UNI_NET_UDP_SERVER_RX_BURST_BUDGET
-#define UNI_NET_UDP_SERVER_RX_BURST_BUDGET          (32U)
+#ifndef UNI_NET_UDP_SERVER_SELECT_TIME_MS
+#define UNI_NET_UDP_SERVER_SELECT_TIME_MS           (100U)
 #endif
 
-#ifndef UNI_NET_UDP_SERVER_RX_QUEUE_PACKETS
-#define UNI_NET_UDP_SERVER_RX_QUEUE_PACKETS         (64U)
+#ifndef UNI_NET_UDP_SERVER_NETWORK_WAITERS
+#define UNI_NET_UDP_SERVER_NETWORK_WAITERS          (4U)
 #endif
 
 //
-// Private types
+// Globals
 //
 
-typedef struct {
-    const uint8_t*           payload;
-    size_t                   length;
-    uni_net_udp_endpoint_t   from;
-    bool                     release_with_stack;
-} _uni_net_udp_server_rx_item_t;
+// Server tasks blocked until the network comes up, woken by uni_net_udp_server_network_event()
+static TaskHandle_t g_uni_net_udp_server_network_waiters[UNI_NET_UDP_SERVER_NETWORK_WAITERS];
 
 //
 // Private helpers
@@ -88,33 +91,36 @@ static inline int32_t _map_timeout_to_wouldblock(int32_t rv) {
     return rv;
 }
 
-static inline void _stats_reset_for_ctx(uni_net_udp_server_context_t* ctx) {
-    if (ctx == nullptr) {
-        return;
-    }
-    ctx->state.rx_packets_total = 0U;
-    ctx->state.rx_drop_total = 0U;
+/*
+ * Port index 0 is the primary socket (bind_port/on_receive), 1..ports_count map to config.ports.
+ */
+static Socket_t _port_socket(const uni_net_udp_server_context_t* ctx, uint32_t index) {
+    return (index == 0U) ? ctx->state.socket : ctx->state.port_sockets[index - 1U];
 }
 
-static inline void _stats_add_packets(uni_net_udp_server_context_t* ctx, uint64_t amount) {
-    if (ctx == nullptr) {
-        return;
+static uni_net_udp_server_recv_cb _port_callback(const uni_net_udp_server_context_t* ctx, uint32_t index, void** out_user) {
+    if (index == 0U) {
+        *out_user = ctx->config.user;
+        return ctx->config.on_receive;
     }
-    ctx->state.rx_packets_total += amount;
+    *out_user = ctx->config.ports[index - 1U].user;
+    return ctx->config.ports[index - 1U].on_receive;
 }
 
-static inline void _stats_add_drops(uni_net_udp_server_context_t* ctx, uint64_t amount) {
-    if (ctx == nullptr) {
-        return;
-    }
-    ctx->state.rx_drop_total += amount;
+static bool _has_receivers(const uni_net_udp_server_context_t* ctx) {
+    return (ctx->config.on_receive != nullptr) || (ctx->config.ports_count > 0U);
 }
 
-static inline uint64_t _stats_get_drop_count(const uni_net_udp_server_context_t* ctx) {
-    if (ctx == nullptr) {
-        return 0U;
-    }
-    return ctx->state.rx_drop_total;
+static inline void _stats_add_drops(uni_net_udp_server_context_t* ctx, uni_net_udp_drop_reason_e reason, uint32_t amount) {
+    uni_net_udp_stats_add_drop(ctx->state.stats, reason, amount);
+}
+
+static void _invoke_callback(uni_net_udp_server_context_t* ctx, uni_net_udp_server_recv_cb on_receive, void* user,
+                             const uint8_t* payload, size_t length, const uni_net_udp_endpoint_t* from) {
+    const uint32_t started = UNI_NET_UDP_STATS_CLOCK_US();
+    uni_net_udp_batch_account_delay(ctx->state.stats, payload, started);
+    on_receive(user, payload, length, from);
+    uni_net_udp_stats_add_callback_time(ctx->state.stats, UNI_NET_UDP_STATS_CLOCK_US() - started);
 }
 
 static void _endpoint_from_sockaddr(const struct freertos_sockaddr* from, uni_net_udp_endpoint_t* ep) {
@@ -149,80 +155,605 @@ static uint32_t _udp_rx_queue_packets_value(void) {
 #endif
 }
 
-static size_t _recv_batch(uni_net_udp_server_context_t* ctx,
-                          Socket_t s,
-                          _uni_net_udp_server_rx_item_t* items,
-                          size_t capacity,
-                          bool wait_for_first) {
-    if (ctx == nullptr || !_socket_valid(s) || items == nullptr || capacity == 0U) {
-        return 0U;
+static void _dispatch_batch(uni_net_udp_server_context_t* ctx, uint32_t port_index, const uni_net_udp_batch_item_t* items, size_t count) {
+    if (ctx == nullptr || items == nullptr || count == 0U) {
+        return;
     }
 
-    size_t count = 0U;
-    size_t iterations = 0U;
+    void* user = nullptr;
+    uni_net_udp_server_recv_cb on_receive = _port_callback(ctx, port_index, &user);
 
-    while (iterations < capacity) {
-        const BaseType_t flags = ((count == 0U) && wait_for_first) ? 0 : FREERTOS_MSG_DONTWAIT;
-        struct freertos_sockaddr from = {0};
-        uint32_t from_len = sizeof(from);
-        void* payload = nullptr;
-        int32_t rv = FreeRTOS_recvfrom(s, &payload, 0U, (flags | FREERTOS_ZERO_COPY), &from, &from_len);
-        rv = _map_timeout_to_wouldblock(rv);
+    for (size_t i = 0; i < count; i++) {
+        if (on_receive != nullptr && items[i].payload != nullptr && items[i].length > 0U) {
+            _invoke_callback(ctx, on_receive, user, items[i].payload, items[i].length, &items[i].from);
+        } else {
+            _stats_add_drops(ctx, UNI_NET_UDP_DROP_NO_CALLBACK, 1U);
+        }
 
-        if (rv <= 0) {
-            if (payload != nullptr) {
-                FreeRTOS_ReleaseUDPPayloadBuffer(payload);
-            }
+        if (items[i].payload != nullptr) {
+            FreeRTOS_ReleaseUDPPayloadBuffer(items[i].payload);
+        }
+    }
+}
 
-            if (rv < 0) {
-                _stats_add_drops(ctx, 1U);
-            }
+static uint32_t _endpoint_hash(const uni_net_udp_endpoint_t* from) {
+    uint32_t h = from->addr ^ ((uint32_t)from->port << 16U);
+    h ^= h >> 16U;
+    h *= 0x7FEB352DU;
+    h ^= h >> 15U;
+    return h;
+}
+
+//
+// Rate limiting
+//
+
+static uni_net_udp_server_rate_entry_t* _rate_lookup(uni_net_udp_server_context_t* ctx, const uni_net_udp_endpoint_t* from, TickType_t now) {
+    const uint32_t start = _endpoint_hash(from);
+    uni_net_udp_server_rate_entry_t* victim = nullptr;
+
+    for (uint32_t probe = 0; probe < UNI_NET_UDP_SERVER_RATE_PROBE; probe++) {
+        uni_net_udp_server_rate_entry_t* entry = &ctx->state.rate_table[(start + probe) & (UNI_NET_UDP_SERVER_RATE_SLOTS - 1U)];
+
+        if (!entry->used) {
+            // Slots are never freed, so the peer cannot live further down the probe chain
+            victim = entry;
             break;
         }
+        if (entry->peer.addr == from->addr && entry->peer.port == from->port) {
+            return entry;
+        }
+        if (victim == nullptr || (TickType_t)(now - entry->last_seen) > (TickType_t)(now - victim->last_seen)) {
+            victim = entry;
+        }
+    }
+
+    // Claim an empty slot or reuse the least recently seen one in the probe window
+    victim->used = true;
+    victim->peer = *from;
+    victim->tokens = ctx->config.rate_limit_burst * 1000U;
+    victim->last_refill = now;
+    victim->drops = 0U;
+    return victim;
+}
 
-        items[count].payload = (const uint8_t*)payload;
-        items[count].length = (size_t)rv;
-        _endpoint_from_sockaddr(&from, &items[count].from);
-        items[count].release_with_stack = true;
-        count++;
-        iterations++;
-        continue;
+/*
+ * Charge one datagram to the bucket of its source. The table is shared between the IP task (on_receive_ip)
+ * and the server task (port sockets), hence the critical section.
+ */
+static bool _rate_admit(uni_net_udp_server_context_t* ctx, const uni_net_udp_endpoint_t* from, TickType_t now) {
+    bool result = false;
+
+    taskENTER_CRITICAL();
+    uni_net_udp_server_rate_entry_t* entry = _rate_lookup(ctx, from, now);
+    const uint32_t capacity = ctx->config.rate_limit_burst * 1000U;
+
+    uint64_t refill = ((uint64_t)(TickType_t)(now - entry->last_refill) * ctx->config.rate_limit_pps * 1000U) / configTICK_RATE_HZ;
+    if (refill > 0U) {
+        entry->tokens = (refill >= (uint64_t)(capacity - entry->tokens)) ? capacity : (entry->tokens + (uint32_t)refill);
+        entry->last_refill = now;
     }
+    entry->last_seen = now;
 
-    return count;
+    if (entry->tokens >= 1000U) {
+        entry->tokens -= 1000U;
+        result = true;
+    } else {
+        entry->drops++;
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
 }
 
-static void _dispatch_batch(uni_net_udp_server_context_t* ctx, const _uni_net_udp_server_rx_item_t* items, size_t count) {
-    if (ctx == nullptr || items == nullptr || count == 0U) {
-        return;
+/*
+ * Drop over-budget datagrams from the batch before dispatch, compacting the admitted ones in place.
+ */
+static size_t _rate_filter(uni_net_udp_server_context_t* ctx, uint32_t port_index, uni_net_udp_batch_item_t* items, size_t count) {
+    // Datagrams retained by on_receive_ip were already charged on the IP task
+    if (ctx->config.rate_limit_pps == 0U || (port_index == 0U && ctx->config.on_receive_ip != nullptr)) {
+        return count;
     }
 
+    const TickType_t now = xTaskGetTickCount();
+    size_t admitted = 0U;
+
     for (size_t i = 0; i < count; i++) {
-        if (ctx->config.on_receive != nullptr && items[i].payload != nullptr && items[i].length > 0U) {
-            ctx->config.on_receive(ctx->config.user, items[i].payload, items[i].length, &items[i].from);
+        if (_rate_admit(ctx, &items[i].from, now)) {
+            items[admitted++] = items[i];
         } else {
-            _stats_add_drops(ctx, 1U);
+            if (items[i].payload != nullptr) {
+                FreeRTOS_ReleaseUDPPayloadBuffer(items[i].payload);
+            }
+            _stats_add_drops(ctx, UNI_NET_UDP_DROP_RATE_LIMITED, 1U);
         }
+    }
 
-        if (items[i].release_with_stack && items[i].payload != nullptr) {
-            FreeRTOS_ReleaseUDPPayloadBuffer(items[i].payload);
+    return admitted;
+}
+
+//
+// IP task receive
+//
+
+#if ( ipconfigUSE_CALLBACKS == 1 )
+static BaseType_t _ip_task_receive(Socket_t s, void* data, size_t length, const struct freertos_sockaddr* from, const struct freertos_sockaddr* dest) {
+    (void)dest;
+
+    uni_net_udp_batch_stamp(data);
+
+    // on_receive_ip serves bind_port only; port sockets carry the handler for stamping
+    uni_net_udp_server_context_t* ctx = (uni_net_udp_server_context_t*)pvSocketGetSocketID(s);
+    if (ctx == nullptr || s != ctx->state.socket || ctx->config.on_receive_ip == nullptr || data == nullptr || length == 0U) {
+        return 0;
+    }
+
+    uni_net_udp_endpoint_t ep = {0};
+    _endpoint_from_sockaddr(from, &ep);
+
+    if (ctx->config.rate_limit_pps != 0U && !_rate_admit(ctx, &ep, xTaskGetTickCount())) {
+        // Consumed without reaching the callback, the stack releases the buffer
+        _stats_add_drops(ctx, UNI_NET_UDP_DROP_RATE_LIMITED, 1U);
+        return 1;
+    }
+
+    const uint32_t started = UNI_NET_UDP_STATS_CLOCK_US();
+    uni_net_udp_server_rx_verdict_e verdict = ctx->config.on_receive_ip(ctx->config.user, (const uint8_t*)data, length, &ep);
+    uni_net_udp_stats_add_callback_time(ctx->state.stats, UNI_NET_UDP_STATS_CLOCK_US() - started);
+
+    if (verdict == UNI_NET_UDP_SERVER_RX_VERDICT_RETAIN) {
+        return 0;
+    }
+
+    uni_net_udp_stats_add_rx(ctx->state.stats, 1U, length);
+    return 1;
+}
+#endif
+
+static BaseType_t _apply_ip_task_handler(uni_net_udp_server_context_t* ctx, Socket_t s) {
+    if (ctx->config.on_receive_ip == nullptr && !UNI_NET_UDP_RX_TIMESTAMPS) {
+        return 0;
+    }
+#if ( ipconfigUSE_CALLBACKS == 1 )
+    F_TCP_UDP_Handler_t handler = {0};
+    handler.pxOnUDPReceive = _ip_task_receive;
+    (void)xSocketSetSocketID(s, ctx);
+    return FreeRTOS_setsockopt(s, 0, FREERTOS_SO_UDP_RECV_HANDLER, &handler, sizeof(handler));
+#else
+    (void)s;
+    return -pdFREERTOS_ERRNO_ENOPROTOOPT;
+#endif
+}
+
+//
+// Worker pool
+//
+
+static uint32_t _worker_index(const uni_net_udp_endpoint_t* from, uint32_t count) {
+    // Same peer always maps to the same worker to keep per-peer ordering
+    return _endpoint_hash(from) % count;
+}
+
+static void _dispatch_to_workers(uni_net_udp_server_context_t* ctx, uint32_t port_index, const uni_net_udp_batch_item_t* items, size_t count) {
+    uint32_t notify_mask = 0U;
+
+    for (size_t i = 0; i < count; i++) {
+        bool queued = false;
+
+        if (items[i].payload != nullptr && items[i].length > 0U) {
+            uint32_t idx = _worker_index(&items[i].from, ctx->state.workers_count);
+            uni_net_udp_ring_item_t ring_item = {0};
+            ring_item.payload = items[i].payload;
+            ring_item.length = items[i].length;
+            ring_item.from = items[i].from;
+            ring_item.port_index = port_index;
+
+            queued = uni_net_udp_ring_push(ctx->state.workers[idx].ring, &ring_item);
+            if (queued) {
+                notify_mask |= (1U << idx);
+            }
+        }
+
+        if (!queued) {
+            // Ring full: never wait on application processing, drop instead
+            _stats_add_drops(ctx, UNI_NET_UDP_DROP_QUEUE_FULL, 1U);
+            if (items[i].payload != nullptr) {
+                FreeRTOS_ReleaseUDPPayloadBuffer(items[i].payload);
+            }
         }
     }
 
-    _stats_add_packets(ctx, count);
+    // One wakeup per worker per batch
+    for (uint32_t idx = 0; idx < ctx->state.workers_count; idx++) {
+        if ((notify_mask & (1U << idx)) != 0U) {
+            (void)xTaskNotifyGive(ctx->state.workers[idx].task);
+        }
+    }
+}
+
+static void _uni_net_udp_server_worker_task(void* arg) {
+    uni_net_udp_server_worker_t* worker = (uni_net_udp_server_worker_t*)arg;
+    uni_net_udp_server_context_t* ctx = (uni_net_udp_server_context_t*)worker->owner;
+    uni_net_udp_ring_item_t item = {0};
+
+    while (!worker->stop_requested) {
+        while (uni_net_udp_ring_pop(worker->ring, &item)) {
+            void* user = nullptr;
+            uni_net_udp_server_recv_cb on_receive = _port_callback(ctx, item.port_index, &user);
+            if (on_receive != nullptr) {
+                _invoke_callback(ctx, on_receive, user, item.payload, item.length, &item.from);
+            } else {
+                _stats_add_drops(ctx, UNI_NET_UDP_DROP_NO_CALLBACK, 1U);
+            }
+            FreeRTOS_ReleaseUDPPayloadBuffer(item.payload);
+        }
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    worker->task = nullptr;
+    (void)xSemaphoreGive(ctx->state.exited);
+    vTaskDelete(nullptr);
+}
+
+static void _workers_stop(uni_net_udp_server_context_t* ctx) {
+    for (uint32_t i = 0; i < ctx->state.workers_count; i++) {
+        uni_net_udp_server_worker_t* worker = &ctx->state.workers[i];
+
+        worker->stop_requested = true;
+        if (worker->task != nullptr) {
+            (void)xTaskNotifyGive(worker->task);
+            (void)xSemaphoreTake(ctx->state.exited, portMAX_DELAY);
+        }
+
+        if (worker->ring != nullptr) {
+            uni_net_udp_ring_item_t item = {0};
+            while (uni_net_udp_ring_pop(worker->ring, &item)) {
+                FreeRTOS_ReleaseUDPPayloadBuffer(item.payload);
+            }
+            uni_net_udp_ring_delete(worker->ring);
+            worker->ring = nullptr;
+        }
+    }
+    ctx->state.workers_count = 0U;
+}
+
+static bool _workers_start(uni_net_udp_server_context_t* ctx) {
+    uint32_t count = _has_receivers(ctx) ? ctx->config.rx_workers : 0U;
+    if (count > UNI_NET_UDP_SERVER_RX_WORKERS_MAX) {
+        count = UNI_NET_UDP_SERVER_RX_WORKERS_MAX;
+    }
+
+    bool result = true;
+    for (uint32_t i = 0; (i < count) && result; i++) {
+        uni_net_udp_server_worker_t* worker = &ctx->state.workers[i];
+        worker->owner = ctx;
+        worker->stop_requested = false;
+        worker->ring = uni_net_udp_ring_create(ctx->config.rx_ring_depth);
+        ctx->state.workers_count = i + 1U;
+
+        result = (worker->ring != nullptr)
+              && (xTaskCreate(_uni_net_udp_server_worker_task, "UNI_NET_UDP_WORKER", ctx->config.task_stack_words,
+                              worker, ctx->config.task_priority, &worker->task) == pdTRUE);
+    }
+
+    if (!result) {
+        _workers_stop(ctx);
+    }
+    return result;
+}
+
+//
+// Multi-port
+//
+
+static void _ports_close(uni_net_udp_server_context_t* ctx) {
+    if (ctx->state.socket_set != nullptr) {
+        for (uint32_t i = 0; i <= ctx->config.ports_count; i++) {
+            Socket_t s = _port_socket(ctx, i);
+            if (_socket_valid(s)) {
+                FreeRTOS_FD_CLR(s, ctx->state.socket_set, eSELECT_ALL);
+            }
+        }
+        FreeRTOS_DeleteSocketSet(ctx->state.socket_set);
+        ctx->state.socket_set = nullptr;
+    }
+
+    for (uint32_t i = 0; i < UNI_NET_UDP_SERVER_PORTS_MAX; i++) {
+        if (_socket_valid(ctx->state.port_sockets[i])) {
+            FreeRTOS_closesocket(ctx->state.port_sockets[i]);
+            ctx->state.port_sockets[i] = FREERTOS_INVALID_SOCKET;
+        }
+    }
+}
+
+static bool _ports_open(uni_net_udp_server_context_t* ctx) {
+    bool result = true;
+
+    for (uint32_t i = 0; (i < ctx->config.ports_count) && result; i++) {
+        Socket_t s = FreeRTOS_socket(FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP);
+        result = _socket_valid(s);
+
+        if (result) {
+            ctx->state.port_sockets[i] = s;
+            _apply_udp_rx_queue_tuning(s);
+
+            struct freertos_sockaddr local = {0};
+            local.sin_family = FREERTOS_AF_INET;
+            local.sin_port = uni_common_bytes_swap16(ctx->config.ports[i].port);
+            local.sin_address.ulIP_IPv4 = ctx->config.bind_addr;
+
+            result = (_apply_timeouts(s, ctx->config.rx_timeout_ms, ctx->config.tx_timeout_ms) == 0)
+                  && (_apply_ip_task_handler(ctx, s) == 0)
+                  && (FreeRTOS_bind(s, &local, sizeof(local)) == 0);
+        }
+    }
+
+    if (result && ctx->config.ports_count > 0U) {
+        ctx->state.socket_set = FreeRTOS_CreateSocketSet();
+        result = (ctx->state.socket_set != nullptr);
+
+        for (uint32_t i = 0; result && (i <= ctx->config.ports_count); i++) {
+            void* user = nullptr;
+            Socket_t s = _port_socket(ctx, i);
+            if (_socket_valid(s) && _port_callback(ctx, i, &user) != nullptr) {
+                FreeRTOS_FD_SET(s, ctx->state.socket_set, eSELECT_READ);
+            }
+        }
+    }
+
+    if (!result) {
+        _ports_close(ctx);
+    }
+    return result;
+}
+
+//
+// Synchronous receive
+//
+
+static bool _sync_set_open(uni_net_udp_server_context_t* ctx) {
+    if (ctx->config.on_receive != nullptr) {
+        return true;
+    }
+    ctx->state.sync_set = FreeRTOS_CreateSocketSet();
+    ctx->state.sync_lock = xSemaphoreCreateMutex();
+    if (ctx->state.sync_set == nullptr || ctx->state.sync_lock == nullptr) {
+        return false;
+    }
+    FreeRTOS_FD_SET(ctx->state.socket, ctx->state.sync_set, eSELECT_READ);
+    return true;
+}
+
+static void _sync_set_close(uni_net_udp_server_context_t* ctx) {
+    if (ctx->state.sync_set != nullptr) {
+        if (_socket_valid(ctx->state.socket)) {
+            FreeRTOS_FD_CLR(ctx->state.socket, ctx->state.sync_set, eSELECT_ALL);
+        }
+        FreeRTOS_DeleteSocketSet(ctx->state.sync_set);
+        ctx->state.sync_set = nullptr;
+    }
+    if (ctx->state.sync_lock != nullptr) {
+        vSemaphoreDelete(ctx->state.sync_lock);
+        ctx->state.sync_lock = nullptr;
+    }
+}
+
+/*
+ * Non-blocking read; when nothing is queued and wait is set, sleep in FreeRTOS_select() until the
+ * socket becomes readable or the caller's deadline expires.
+ */
+static int32_t _recv_until(uni_net_udp_server_context_t* ctx, uint8_t* buf, size_t buf_size, uni_net_udp_endpoint_t* out_from,
+                           TimeOut_t* timeout, TickType_t* remaining, bool wait) {
+    for (;;) {
+        struct freertos_sockaddr from = {0};
+        uint32_t from_len = sizeof(from);
+        int32_t rv = FreeRTOS_recvfrom(ctx->state.socket, buf, (int32_t)buf_size, FREERTOS_MSG_DONTWAIT, &from, &from_len);
+
+        if (rv != -pdFREERTOS_ERRNO_EWOULDBLOCK) {
+            if (rv >= 0 && out_from != nullptr && from_len >= sizeof(from)) {
+                _endpoint_from_sockaddr(&from, out_from);
+            }
+            return _map_timeout_to_wouldblock(rv);
+        }
+
+        if (!wait || xTaskCheckForTimeOut(timeout, remaining) != pdFALSE) {
+            return UNI_NET_UDP_RET_TIMEOUT;
+        }
+        (void)FreeRTOS_select(ctx->state.sync_set, *remaining);
+    }
+}
+
+/*
+ * Take the synchronous receive slot: select() on the shared set wakes one waiter per datagram, a second
+ * waiter would steal the wakeup of the first. Waiting for the slot is charged to the caller's timeout.
+ */
+static bool _sync_enter(uni_net_udp_server_context_t* ctx, TickType_t remaining) {
+    return xSemaphoreTake(ctx->state.sync_lock, remaining) == pdTRUE;
+}
+
+static void _sync_exit(uni_net_udp_server_context_t* ctx) {
+    (void)xSemaphoreGive(ctx->state.sync_lock);
+}
+
+static int32_t _sync_recv_check(const uni_net_udp_server_context_t* ctx) {
+    if (ctx == nullptr || !uni_net_udp_server_is_inited(ctx)) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+    // Cannot be used while event-driven receive task is active
+    if ((ctx->config.on_receive != nullptr) && (ctx->state.task != nullptr)) {
+        return -pdFREERTOS_ERRNO_EALREADY;
+    }
+    if (ctx->state.sync_set == nullptr || ctx->state.sync_lock == nullptr) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+    return 0;
 }
 
 //
 // Task-driven receive
 //
 
+static void _rx_tuning_init(uni_net_udp_server_context_t* ctx) {
+    uni_net_udp_server_config_t* cfg = &ctx->config;
+
+    if (cfg->rx_batch_max == 0U || cfg->rx_batch_max > UNI_NET_UDP_SERVER_RX_BATCH_DEPTH) {
+        cfg->rx_batch_max = UNI_NET_UDP_SERVER_RX_BATCH_DEPTH;
+    }
+    if (cfg->rx_batch_min == 0U || cfg->rx_batch_min > cfg->rx_batch_max) {
+        cfg->rx_batch_min = (cfg->rx_batch_min == 0U) ? 1U : cfg->rx_batch_max;
+    }
+    if (cfg->rx_burst_max == 0U) {
+        cfg->rx_burst_max = uni_common_math_max(UNI_NET_UDP_SERVER_RX_BURST_BUDGET, cfg->rx_batch_max);
+    }
+    if (cfg->rx_burst_min == 0U) {
+        cfg->rx_burst_min = cfg->rx_batch_max;
+    }
+    cfg->rx_burst_min = uni_common_math_min(cfg->rx_burst_min, cfg->rx_burst_max);
+
+    // Start latency-oriented, grow under load
+    for (uint32_t i = 0; i <= UNI_NET_UDP_SERVER_PORTS_MAX; i++) {
+        ctx->state.rx_tuning[i].batch_depth = cfg->rx_batch_min;
+        ctx->state.rx_tuning[i].burst_budget = cfg->rx_burst_min;
+    }
+}
+
+static void _rx_tuning_adapt(uni_net_udp_server_context_t* ctx, uni_net_udp_server_rx_tuning_t* tuning, size_t drained, bool exhausted) {
+    uint32_t batch = tuning->batch_depth;
+    uint32_t burst = tuning->burst_budget;
+
+    if (exhausted) {
+        // Queue refilled faster than one burst drained it: amortise wakeups
+        batch = uni_common_math_min(batch * 2U, ctx->config.rx_batch_max);
+        burst = uni_common_math_min(burst * 2U, ctx->config.rx_burst_max);
+    } else if (drained <= 1U) {
+        // Sparse traffic: hand each datagram over as soon as it arrives
+        batch = uni_common_math_max(batch / 2U, ctx->config.rx_batch_min);
+        burst = uni_common_math_max(burst / 2U, ctx->config.rx_burst_min);
+    }
+
+    if (batch != tuning->batch_depth || burst != tuning->burst_budget) {
+        // Published as a pair for uni_net_udp_server_get_rx_tuning()
+        taskENTER_CRITICAL();
+        tuning->batch_depth = batch;
+        tuning->burst_budget = burst;
+        taskEXIT_CRITICAL();
+        uni_net_udp_stats_set_rx_tuning(ctx->state.stats, batch, burst);
+    }
+}
+
+/*
+ * Burst-drain one socket into the callback of the given port, bounded by the burst budget so that
+ * other sockets of the same task are not starved.
+ */
+static void _drain_socket(uni_net_udp_server_context_t* ctx, uint32_t port_index, Socket_t s, bool wait_for_first) {
+    uni_net_udp_batch_item_t batch[UNI_NET_UDP_SERVER_RX_BATCH_DEPTH] = {0};
+    uni_net_udp_server_rx_tuning_t* tuning = &ctx->state.rx_tuning[port_index];
+    size_t burst_budget = tuning->burst_budget;
+    size_t drained = 0U;
+
+    while (!ctx->state.stop_requested && (burst_budget > 0U)) {
+        const size_t cap = (burst_budget > tuning->batch_depth)
+                               ? tuning->batch_depth
+                               : burst_budget;
+
+        const size_t received = uni_net_udp_batch_recv(s, batch, cap, wait_for_first, ctx->state.stats);
+
+        if (received == 0U) {
+            break;
+        }
+
+        wait_for_first = false;
+        burst_budget -= received;
+        drained += received;
+
+        const size_t admitted = _rate_filter(ctx, port_index, batch, received);
+        if (admitted == 0U) {
+            continue;
+        }
+        if (ctx->state.workers_count > 0U) {
+            _dispatch_to_workers(ctx, port_index, batch, admitted);
+        } else {
+            _dispatch_batch(ctx, port_index, batch, admitted);
+        }
+    }
+
+    // Datagrams found queued on the socket in one wakeup, a lower bound of the socket queue depth
+    uni_net_udp_stats_update_queue(ctx->state.stats, (uint32_t)drained);
+    _rx_tuning_adapt(ctx, tuning, drained, (burst_budget == 0U));
+}
+
+/*
+ * Make the select loop recompute its wait. The signal stays pending on the set until the next select
+ * consumes it, so a loop that is not waiting yet does not miss it.
+ */
+static void _select_wake(uni_net_udp_server_context_t* ctx) {
+#if ( ipconfigSUPPORT_SIGNALS != 0 )
+    if (ctx->state.socket_set == nullptr) {
+        return;
+    }
+    for (uint32_t i = 0; i <= ctx->config.ports_count; i++) {
+        void* user = nullptr;
+        Socket_t s = _port_socket(ctx, i);
+        // Any member interrupts the whole set
+        if (_socket_valid(s) && _port_callback(ctx, i, &user) != nullptr) {
+            (void)FreeRTOS_SignalSocket(s);
+            break;
+        }
+    }
+#else
+    (void)ctx;
+#endif
+}
+
+static void _select_loop(uni_net_udp_server_context_t* ctx) {
+    while (!ctx->state.stop_requested) {
+        // Stop and group changes interrupt the select through the socket signal, only IGMP reports need a
+        // timed wakeup: an idle server without groups sleeps until traffic arrives
+        TickType_t wait = uni_net_udp_igmp_refresh();
+#if ( ipconfigSUPPORT_SIGNALS == 0 )
+        wait = uni_common_math_min(wait, pdMS_TO_TICKS(UNI_NET_UDP_SERVER_SELECT_TIME_MS));
+#endif
+        if (FreeRTOS_select(ctx->state.socket_set, wait) <= 0) {
+            continue;
+        }
+
+        for (uint32_t i = 0; i <= ctx->config.ports_count; i++) {
+            Socket_t s = _port_socket(ctx, i);
+            if (_socket_valid(s) && ((FreeRTOS_FD_ISSET(s, ctx->state.socket_set) & eSELECT_READ) != 0)) {
+                _drain_socket(ctx, i, s, false);
+            }
+        }
+    }
+}
+
+static void _network_waiter_set(TaskHandle_t task, bool add) {
+    vTaskSuspendAll();
+    for (uint32_t i = 0; i < UNI_NET_UDP_SERVER_NETWORK_WAITERS; i++) {
+        if (add ? (g_uni_net_udp_server_network_waiters[i] == nullptr) : (g_uni_net_udp_server_network_waiters[i] == task)) {
+            g_uni_net_udp_server_network_waiters[i] = add ? task : nullptr;
+            break;
+        }
+    }
+    (void)xTaskResumeAll();
+}
+
+static void _network_wait(uni_net_udp_server_context_t* ctx) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    // Woken by uni_net_udp_server_network_event() or stop; the timeout covers applications not forwarding
+    // network events and a full waiter table
+    _network_waiter_set(self, true);
+    while ((FreeRTOS_IsNetworkUp() == pdFALSE) && !ctx->state.stop_requested) {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(UNI_NET_UDP_SERVER_IFACE_TIME_MS));
+    }
+    _network_waiter_set(self, false);
+}
+
 static void _uni_net_udp_server_task(void *arg) {
     uni_net_udp_server_context_t *ctx = (uni_net_udp_server_context_t *) arg;
 
     // Wait for network up before binding/creating socket
-    while ((FreeRTOS_IsNetworkUp() == pdFALSE) && !ctx->state.stop_requested) {
-        vTaskDelay(pdMS_TO_TICKS(UNI_NET_UDP_SERVER_IFACE_TIME_MS));
-    }
+    _network_wait(ctx);
 
     if (!ctx->state.stop_requested) {
         // Create synchronization primitive
@@ -234,7 +765,8 @@ static void _uni_net_udp_server_task(void *arg) {
 
             if (_socket_valid(ctx->state.socket)) {
                 // Apply timeouts and checksum option
-                if (_apply_timeouts(ctx->state.socket, ctx->config.rx_timeout_ms, ctx->config.tx_timeout_ms) == 0) {
+                if (_apply_timeouts(ctx->state.socket, ctx->config.rx_timeout_ms, ctx->config.tx_timeout_ms) == 0
+                 && _apply_ip_task_handler(ctx, ctx->state.socket) == 0) {
                     _apply_udp_rx_queue_tuning(ctx->state.socket);
                     ctx->state.rx_queue_packets = _udp_rx_queue_packets_value();
 
@@ -244,9 +776,14 @@ static void _uni_net_udp_server_task(void *arg) {
                     local.sin_port = uni_common_bytes_swap16(ctx->config.bind_port);
                     local.sin_address.ulIP_IPv4 = ctx->config.bind_addr;
 
-                    if (FreeRTOS_bind(ctx->state.socket, &local, sizeof(local)) == 0) {
+                    if (FreeRTOS_bind(ctx->state.socket, &local, sizeof(local)) == 0
+                     && _sync_set_open(ctx)
+                     && _ports_open(ctx)
+                     && _workers_start(ctx)) {
                         ctx->state.initialized = true;
                     } else {
+                        _ports_close(ctx);
+                        _sync_set_close(ctx);
                         FreeRTOS_closesocket(ctx->state.socket);
                         ctx->state.socket = FREERTOS_INVALID_SOCKET;
                     }
@@ -263,13 +800,6 @@ static void _uni_net_udp_server_task(void *arg) {
         }
     }
 
-    // If configured without event-driven receive, idle until stop is requested
-    if (!ctx->state.stop_requested && ctx->config.on_receive == nullptr) {
-        while (!ctx->state.stop_requested) {
-            vTaskDelay(pdMS_TO_TICKS(10));
-        }
-    }
-
     /*
      * Event-driven receive loop.
      *
@@ -281,43 +811,23 @@ static void _uni_net_udp_server_task(void *arg) {
      *     1) UDP zero-copy receive (`FREERTOS_ZERO_COPY`),
      *     2) burst-drain batching in non-blocking mode (`FREERTOS_MSG_DONTWAIT`).
      */
-    while (!ctx->state.stop_requested && ctx->config.on_receive != nullptr) {
-        _uni_net_udp_server_rx_item_t batch[UNI_NET_UDP_SERVER_RX_BATCH_DEPTH] = {0};
-        size_t burst_budget = UNI_NET_UDP_SERVER_RX_BURST_BUDGET;
-        bool wait_for_first = true;
-
-        _lock(ctx);
-        Socket_t s = ctx->state.socket;
-        _unlock(ctx);
-
-        if (!_socket_valid(s)) {
-            vTaskDelay(pdMS_TO_TICKS(10));
-            continue;
-        }
-
-        while (!ctx->state.stop_requested && (burst_budget > 0U)) {
-            const size_t cap = (burst_budget > UNI_NET_UDP_SERVER_RX_BATCH_DEPTH)
-                                   ? UNI_NET_UDP_SERVER_RX_BATCH_DEPTH
-                                   : burst_budget;
-
-            const size_t received = _recv_batch(ctx,
-                                                s,
-                                                batch,
-                                                cap,
-                                                wait_for_first);
+    if (!ctx->state.stop_requested && ctx->state.socket_set != nullptr) {
+        _select_loop(ctx);
+    }
 
-            if (received == 0U) {
-                break;
-            }
+    while (!ctx->state.stop_requested && ctx->state.initialized && ctx->config.on_receive != nullptr) {
+        (void)uni_net_udp_igmp_refresh();
+        _drain_socket(ctx, 0U, ctx->state.socket, true);
+    }
 
-            wait_for_first = false;
-            burst_budget -= received;
-            _dispatch_batch(ctx, batch, received);
-        }
+    // Synchronous mode or failed initialization: nothing to serve, sleep until stop is requested
+    while (!ctx->state.stop_requested) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     }
 
-    // Task exit
+    // Task exit, uni_net_udp_server_stop() joins on the semaphore
     ctx->state.task = nullptr;
+    (void)xSemaphoreGive(ctx->state.exited);
     vTaskDelete(nullptr);
 }
 
@@ -330,7 +840,6 @@ bool uni_net_udp_server_start(uni_net_udp_server_context_t *ctx, const uni_net_u
 
     if (ctx != nullptr) {
         memset(ctx, 0, sizeof(*ctx));
-        _stats_reset_for_ctx(ctx);
 
         // Defaults
         ctx->config.bind_addr = FREERTOS_INADDR_ANY;
@@ -341,6 +850,9 @@ bool uni_net_udp_server_start(uni_net_udp_server_context_t *ctx, const uni_net_u
         ctx->config.user = nullptr;
         ctx->config.task_priority = UNI_NET_UDP_SERVER_TASK_PRIORITY;
         ctx->config.task_stack_words = UNI_NET_UDP_SERVER_TASK_STACK_WORDS;
+        ctx->config.on_receive_ip = nullptr;
+        ctx->config.rx_workers = 0U;
+        ctx->config.rx_ring_depth = UNI_NET_UDP_SERVER_RX_RING_DEPTH;
         if (cfg != nullptr) {
             ctx->config.bind_addr = cfg->bind_addr;
             ctx->config.bind_port = cfg->bind_port;
@@ -350,23 +862,48 @@ bool uni_net_udp_server_start(uni_net_udp_server_context_t *ctx, const uni_net_u
             ctx->config.user = cfg->user;
             ctx->config.task_priority = cfg->task_priority;
             ctx->config.task_stack_words = cfg->task_stack_words;
+            ctx->config.on_receive_ip = cfg->on_receive_ip;
+            ctx->config.rx_workers = cfg->rx_workers;
+            if (cfg->rx_ring_depth != 0U) {
+                ctx->config.rx_ring_depth = cfg->rx_ring_depth;
+            }
+            ctx->config.rx_batch_min = cfg->rx_batch_min;
+            ctx->config.rx_batch_max = cfg->rx_batch_max;
+            ctx->config.rx_burst_min = cfg->rx_burst_min;
+            ctx->config.rx_burst_max = cfg->rx_burst_max;
+            ctx->config.rate_limit_pps = cfg->rate_limit_pps;
+            ctx->config.rate_limit_burst = (cfg->rate_limit_burst != 0U) ? cfg->rate_limit_burst : cfg->rate_limit_pps;
+            ctx->config.ports_count = (cfg->ports_count > UNI_NET_UDP_SERVER_PORTS_MAX) ? UNI_NET_UDP_SERVER_PORTS_MAX : cfg->ports_count;
+            memcpy(ctx->config.ports, cfg->ports, ctx->config.ports_count * sizeof(ctx->config.ports[0]));
         }
+        _rx_tuning_init(ctx);
         ctx->state.initialized = false;
         ctx->state.stop_requested = false;
+        ctx->state.stats = uni_net_udp_stats_create();
+        uni_net_udp_stats_set_rx_tuning(ctx->state.stats, ctx->config.rx_batch_min, ctx->config.rx_burst_min);
+
+        ctx->state.exited = xSemaphoreCreateBinary();
 
         // Always create a task; it will perform all initialization internally
-        BaseType_t created = xTaskCreate(
-            _uni_net_udp_server_task,
-            "UNI_NET_UDP_SERVER",
-            ctx->config.task_stack_words,
-            ctx,
-            ctx->config.task_priority,
-            &ctx->state.task
-        );
+        BaseType_t created = pdFALSE;
+        if (ctx->state.stats != nullptr && ctx->state.exited != nullptr) {
+            created = xTaskCreate(
+                _uni_net_udp_server_task,
+                "UNI_NET_UDP_SERVER",
+                ctx->config.task_stack_words,
+                ctx,
+                ctx->config.task_priority,
+                &ctx->state.task
+            );
+        }
         if (created == pdTRUE) {
             result = true;
         }
         else{
+            if (ctx->state.exited != nullptr) {
+                vSemaphoreDelete(ctx->state.exited);
+            }
+            uni_net_udp_stats_delete(ctx->state.stats);
             memset(ctx, 0, sizeof(*ctx));
         }
     }
@@ -385,21 +922,37 @@ bool uni_net_udp_server_stop(uni_net_udp_server_context_t *ctx) {
     // Request task termination if running
     ctx->state.stop_requested = true;
 
-    // Speed up task exit by reducing receive timeout (if socket exists)
-    _lock(ctx);
-    if (_socket_valid(ctx->state.socket)) {
-        TickType_t rx_ticks = pdMS_TO_TICKS(50U);
-        (void) FreeRTOS_setsockopt(ctx->state.socket, 0, FREERTOS_SO_RCVTIMEO, &rx_ticks, sizeof(rx_ticks));
-    }
-    _unlock(ctx);
+    if (ctx->state.task != nullptr) {
+        // Wake the task wherever it blocks: network wait and idle sleep on its notification,
+        // receive and select through the socket signal
+        (void) xTaskNotifyGive(ctx->state.task);
+        // Every socket gets the signal: with extra ports the select waits on the port sockets and the
+        // main socket only sits in it when it has a callback
+        _lock(ctx);
+        for (uint32_t i = 0; i <= ctx->config.ports_count; i++) {
+            Socket_t s = _port_socket(ctx, i);
+            if (_socket_valid(s)) {
+#if ( ipconfigSUPPORT_SIGNALS != 0 )
+                (void) FreeRTOS_SignalSocket(s);
+#else
+                TickType_t rx_ticks = pdMS_TO_TICKS(50U);
+                (void) FreeRTOS_setsockopt(s, 0, FREERTOS_SO_RCVTIMEO, &rx_ticks, sizeof(rx_ticks));
+#endif
+            }
+        }
+        _unlock(ctx);
 
-    // Wait for task exit if it exists
-    while (ctx->state.task != nullptr) {
-        vTaskDelay(pdMS_TO_TICKS(10));
+        (void) xSemaphoreTake(ctx->state.exited, portMAX_DELAY);
     }
 
-    // Close socket
+    // Producer is gone: stop workers and release datagrams still queued in the rings
+    _workers_stop(ctx);
+
+    // Close sockets
     _lock(ctx);
+    uni_net_udp_igmp_set_clear(&ctx->state.mcast);
+    _ports_close(ctx);
+    _sync_set_close(ctx);
     if (_socket_valid(ctx->state.socket)) {
         FreeRTOS_closesocket(ctx->state.socket);
         ctx->state.socket = FREERTOS_INVALID_SOCKET;
@@ -410,6 +963,10 @@ bool uni_net_udp_server_stop(uni_net_udp_server_context_t *ctx) {
     if (ctx->state.lock != nullptr) {
         vSemaphoreDelete(ctx->state.lock);
     }
+    if (ctx->state.exited != nullptr) {
+        vSemaphoreDelete(ctx->state.exited);
+    }
+    uni_net_udp_stats_delete(ctx->state.stats);
 
     memset(ctx, 0, sizeof(*ctx));
     return true;
@@ -417,44 +974,81 @@ bool uni_net_udp_server_stop(uni_net_udp_server_context_t *ctx) {
 
 int32_t uni_net_udp_server_recvfrom(uni_net_udp_server_context_t *ctx, uint8_t *buf, size_t buf_size,
                                     uni_net_udp_endpoint_t *out_from, uint32_t timeout_ms) {
-    if (ctx == nullptr || buf == nullptr || buf_size == 0 || !uni_net_udp_server_is_inited(ctx)) {
+    if (buf == nullptr || buf_size == 0) {
         return -pdFREERTOS_ERRNO_EINVAL;
     }
-    // Cannot be used while event-driven receive task is active
-    if ((ctx->config.on_receive != nullptr) && (ctx->state.task != nullptr)) {
-        return -pdFREERTOS_ERRNO_EALREADY;
+    int32_t rv = _sync_recv_check(ctx);
+    if (rv < 0) {
+        return rv;
     }
+    (void)uni_net_udp_igmp_refresh();
 
-    struct freertos_sockaddr from = {0};
-    uint32_t from_len = sizeof(from);
-
-    // Temporarily override RCVTIMEO for this call
-    _lock(ctx);
-    Socket_t s = ctx->state.socket;
-    TickType_t orig_ticks = pdMS_TO_TICKS(ctx->config.rx_timeout_ms);
-    TickType_t temp_ticks = pdMS_TO_TICKS(timeout_ms);
-    (void) FreeRTOS_setsockopt(s, 0, FREERTOS_SO_RCVTIMEO, &temp_ticks, sizeof(temp_ticks));
-    _unlock(ctx);
+    TimeOut_t timeout;
+    TickType_t remaining = pdMS_TO_TICKS(timeout_ms);
+    vTaskSetTimeOutState(&timeout);
 
-    int32_t rv = FreeRTOS_recvfrom(s, buf, (int32_t) buf_size, 0, &from, &from_len);
-    rv = _map_timeout_to_wouldblock(rv);
+    if (!_sync_enter(ctx, remaining)) {
+        return UNI_NET_UDP_RET_TIMEOUT;
+    }
+    rv = _recv_until(ctx, buf, buf_size, out_from, &timeout, &remaining, true);
+    _sync_exit(ctx);
 
     if (rv > 0) {
-        _stats_add_packets(ctx, 1U);
+        uni_net_udp_stats_add_rx(ctx->state.stats, 1U, (size_t)rv);
     } else if (rv < 0) {
-        _stats_add_drops(ctx, 1U);
+        _stats_add_drops(ctx, UNI_NET_UDP_DROP_STACK_ERROR, 1U);
     }
 
-    // Restore original timeout
-    _lock(ctx);
-    (void) FreeRTOS_setsockopt(s, 0, FREERTOS_SO_RCVTIMEO, &orig_ticks, sizeof(orig_ticks));
-    _unlock(ctx);
+    return rv;
+}
 
-    if (rv >= 0 && out_from != nullptr && from_len >= sizeof(from)) {
-        out_from->addr = from.sin_address.ulIP_IPv4;
-        out_from->port = from.sin_port;
+int32_t uni_net_udp_server_recv_batch(uni_net_udp_server_context_t *ctx, uni_net_udp_rx_item_t *items, size_t count,
+                                      uint32_t timeout_ms) {
+    if (items == nullptr || count == 0) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+    int32_t rv = _sync_recv_check(ctx);
+    if (rv < 0) {
+        return rv;
+    }
+
+    TimeOut_t timeout;
+    TickType_t remaining = pdMS_TO_TICKS(timeout_ms);
+    vTaskSetTimeOutState(&timeout);
+
+    if (!_sync_enter(ctx, remaining)) {
+        return UNI_NET_UDP_RET_TIMEOUT;
     }
 
+    size_t received = 0U;
+    size_t bytes = 0U;
+    while (received < count) {
+        uni_net_udp_rx_item_t* item = &items[received];
+        if (item->buf == nullptr || item->buf_size == 0U) {
+            rv = -pdFREERTOS_ERRNO_EINVAL;
+            break;
+        }
+
+        // Only the first datagram is waited for, the rest of the batch is what is already queued
+        rv = _recv_until(ctx, item->buf, item->buf_size, &item->from, &timeout, &remaining, (received == 0U));
+        if (rv <= 0) {
+            break;
+        }
+
+        item->length = (size_t)rv;
+        bytes += (size_t)rv;
+        received++;
+    }
+    _sync_exit(ctx);
+
+    if (rv < 0) {
+        _stats_add_drops(ctx, UNI_NET_UDP_DROP_STACK_ERROR, 1U);
+    }
+    if (received > 0U) {
+        uni_net_udp_stats_add_rx(ctx->state.stats, (uint32_t)received, bytes);
+        uni_net_udp_stats_add_batch(ctx->state.stats, (uint32_t)received);
+        return (int32_t)received;
+    }
     return rv;
 }
 
@@ -469,9 +1063,9 @@ int32_t uni_net_udp_server_sendto(uni_net_udp_server_context_t *ctx, const uint8
     dst.sin_port = to->port;
     dst.sin_address.ulIP_IPv4 = to->addr;
 
-    // Avoid deadlock if called from server task: skip lock in that case
+    // Avoid deadlock if called from server task or from on_receive_ip on the IP task: skip lock in that case
     TaskHandle_t self = xTaskGetCurrentTaskHandle();
-    bool take_lock = (ctx->state.task == nullptr) || (self != ctx->state.task);
+    bool take_lock = ((ctx->state.task == nullptr) || (self != ctx->state.task)) && (self != FreeRTOS_GetIPTaskHandle());
     if (take_lock) {
         _lock(ctx);
     }
@@ -482,12 +1076,44 @@ int32_t uni_net_udp_server_sendto(uni_net_udp_server_context_t *ctx, const uint8
     }
 
     rv = _map_timeout_to_wouldblock(rv);
+    uni_net_udp_stats_add_tx_result(ctx->state.stats, rv);
     if (rv > 0 && (size_t) rv != len) {
         return -pdFREERTOS_ERRNO_EINVAL;
     }
     return rv;
 }
 
+int32_t uni_net_udp_server_sendto_batch(uni_net_udp_server_context_t *ctx, uni_net_udp_tx_item_t *items, size_t count) {
+    if (ctx == nullptr || items == nullptr || count == 0 || !uni_net_udp_server_is_inited(ctx)) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    bool take_lock = ((ctx->state.task == nullptr) || (self != ctx->state.task)) && (self != FreeRTOS_GetIPTaskHandle());
+
+    if (take_lock) {
+        _lock(ctx);
+    }
+    size_t sent = uni_net_udp_batch_send(ctx->state.socket, items, count);
+    if (take_lock) {
+        _unlock(ctx);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        uni_net_udp_stats_add_tx_result(ctx->state.stats, items[i].result);
+    }
+
+    return (int32_t)sent;
+}
+
+int32_t uni_net_udp_server_sendto_large(uni_net_udp_server_context_t *ctx, const uint8_t *buf, size_t len,
+                                        const uni_net_udp_endpoint_t *to) {
+    if (ctx == nullptr || !uni_net_udp_server_is_inited(ctx)) {
+        return -pdFREERTOS_ERRNO_EINVAL;
+    }
+    return uni_net_udp_segment_send(uni_net_udp_coalesce_server_sender, ctx, to, buf, len, ctx->config.tx_timeout_ms);
+}
+
 bool uni_net_udp_server_set_timeouts(uni_net_udp_server_context_t *ctx, uint32_t rx_timeout_ms,
                                      uint32_t tx_timeout_ms) {
     if (ctx == nullptr || !uni_net_udp_server_is_inited(ctx)) {
@@ -521,7 +1147,24 @@ uint64_t uni_net_udp_server_get_rx_drop_count(const uni_net_udp_server_context_t
     if (ctx == nullptr) {
         return 0U;
     }
-    return _stats_get_drop_count(ctx);
+    return uni_net_udp_stats_get_drops(ctx->state.stats, UNI_NET_UDP_DROP_REASON_COUNT);
+}
+
+bool uni_net_udp_server_get_stats(const uni_net_udp_server_context_t *ctx, uni_net_udp_stats_t *out_stats) {
+    if (ctx == nullptr || out_stats == nullptr) {
+        return false;
+    }
+    return uni_net_udp_stats_snapshot(ctx->state.stats, out_stats);
+}
+
+bool uni_net_udp_server_get_rx_tuning(const uni_net_udp_server_context_t *ctx, uint32_t port_index, uni_net_udp_server_rx_tuning_t *out_tuning) {
+    if (ctx == nullptr || out_tuning == nullptr || port_index > ctx->config.ports_count) {
+        return false;
+    }
+    taskENTER_CRITICAL();
+    *out_tuning = ctx->state.rx_tuning[port_index];
+    taskEXIT_CRITICAL();
+    return true;
 }
 
 uint32_t uni_net_udp_server_get_rx_queue_packets(const uni_net_udp_server_context_t *ctx) {
@@ -530,3 +1173,85 @@ uint32_t uni_net_udp_server_get_rx_queue_packets(const uni_net_udp_server_contex
     }
     return ctx->state.rx_queue_packets;
 }
+
+uint64_t uni_net_udp_server_get_rate_limited_count(const uni_net_udp_server_context_t *ctx) {
+    if (ctx == nullptr) {
+        return 0U;
+    }
+    return uni_net_udp_stats_get_drops(ctx->state.stats, UNI_NET_UDP_DROP_RATE_LIMITED);
+}
+
+size_t uni_net_udp_server_get_rate_limited(const uni_net_udp_server_context_t *ctx, uni_net_udp_server_rate_source_t *out_sources, size_t capacity) {
+    if (ctx == nullptr || out_sources == nullptr) {
+        return 0U;
+    }
+
+    size_t count = 0U;
+    for (uint32_t i = 0; (i < UNI_NET_UDP_SERVER_RATE_SLOTS) && (count < capacity); i++) {
+        const uni_net_udp_server_rate_entry_t* entry = &ctx->state.rate_table[i];
+        if (entry->used && entry->drops > 0U) {
+            out_sources[count].peer = entry->peer;
+            out_sources[count].drops = entry->drops;
+            count++;
+        }
+    }
+    return count;
+}
+
+bool uni_net_udp_server_get_ring_stats(const uni_net_udp_server_context_t *ctx, uni_net_udp_server_ring_stats_t *out_stats) {
+    if (ctx == nullptr || out_stats == nullptr) {
+        return false;
+    }
+
+    memset(out_stats, 0, sizeof(*out_stats));
+    for (uint32_t i = 0; i < ctx->state.workers_count; i++) {
+        uni_net_udp_ring_t* ring = ctx->state.workers[i].ring;
+        if (ring != nullptr) {
+            uint32_t high_water = atomic_load_explicit(&ring->high_water, memory_order_relaxed);
+            out_stats->depth += (uint32_t)uni_net_udp_ring_depth(ring);
+            out_stats->overflow_total += atomic_load_explicit(&ring->overflow_total, memory_order_relaxed);
+            if (high_water > out_stats->high_water) {
+                out_stats->high_water = high_water;
+            }
+        }
+    }
+    return true;
+}
+
+bool uni_net_udp_server_join_group(uni_net_udp_server_context_t *ctx, uint32_t group) {
+    if (!uni_net_udp_server_is_inited(ctx)) {
+        return false;
+    }
+    _lock(ctx);
+    const bool result = uni_net_udp_igmp_set_join(&ctx->state.mcast, group);
+    // The select may sleep without a deadline, it picks up the report interval of the new group
+    _select_wake(ctx);
+    _unlock(ctx);
+    return result;
+}
+
+bool uni_net_udp_server_leave_group(uni_net_udp_server_context_t *ctx, uint32_t group) {
+    if (!uni_net_udp_server_is_inited(ctx)) {
+        return false;
+    }
+    _lock(ctx);
+    const bool result = uni_net_udp_igmp_set_leave(&ctx->state.mcast, group);
+    _select_wake(ctx);
+    _unlock(ctx);
+    return result;
+}
+
+void uni_net_udp_server_network_event(eIPCallbackEvent_t event) {
+    if (event != eNetworkUp) {
+        return;
+    }
+
+    // Scheduler suspended: a waiter cannot unregister and exit while it is being notified
+    vTaskSuspendAll();
+    for (uint32_t i = 0; i < UNI_NET_UDP_SERVER_NETWORK_WAITERS; i++) {
+        if (g_uni_net_udp_server_network_waiters[i] != nullptr) {
+            (void)xTaskNotifyGive(g_uni_net_udp_server_network_waiters[i]);
+        }
+    }
+    (void)xTaskResumeAll();
+}
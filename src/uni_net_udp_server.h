@@ -41,6 +41,10 @@ extern "C" {
 #define UNI_NET_UDP_SERVER_TASK_PRIORITY           (2U)
 #endif
 
+/**
+ * Network-up poll period, only used when the application does not forward network events with
+ * uni_net_udp_server_network_event().
+ */
 #ifndef UNI_NET_UDP_SERVER_IFACE_TIME_MS
 #define UNI_NET_UDP_SERVER_IFACE_TIME_MS           (250U)
 #endif
@@ -49,6 +53,51 @@ extern "C" {
 #define UNI_NET_UDP_SERVER_RX_BUF_SIZE             (1536U)
 #endif
 
+/**
+ * Upper limit of datagrams per receive batch (size of the on-stack batch array in the server task).
+ */
+#ifndef UNI_NET_UDP_SERVER_RX_BATCH_DEPTH
+#define UNI_NET_UDP_SERVER_RX_BATCH_DEPTH          (8U)
+#endif
+
+/**
+ * Default upper limit of datagrams drained per wakeup before the task goes back to blocking receive.
+ */
+#ifndef UNI_NET_UDP_SERVER_RX_BURST_BUDGET
+#define UNI_NET_UDP_SERVER_RX_BURST_BUDGET         (32U)
+#endif
+
+/**
+ * Maximum number of additional ports served by one server task (see config.ports).
+ */
+#ifndef UNI_NET_UDP_SERVER_PORTS_MAX
+#define UNI_NET_UDP_SERVER_PORTS_MAX               (8U)
+#endif
+
+#ifndef UNI_NET_UDP_SERVER_RX_WORKERS_MAX
+#define UNI_NET_UDP_SERVER_RX_WORKERS_MAX          (4U)
+#endif
+
+/**
+ * Default per-worker ring depth. Every queued datagram pins one network buffer, so the total
+ * (rx_workers * rx_ring_depth) should stay well below ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS.
+ */
+#ifndef UNI_NET_UDP_SERVER_RX_RING_DEPTH
+#define UNI_NET_UDP_SERVER_RX_RING_DEPTH           (8U)
+#endif
+
+/**
+ * Per-source rate limiter table size (power of two) and probe window. When the window is full the
+ * least recently seen source in it is evicted.
+ */
+#ifndef UNI_NET_UDP_SERVER_RATE_SLOTS
+#define UNI_NET_UDP_SERVER_RATE_SLOTS              (32U)
+#endif
+
+#ifndef UNI_NET_UDP_SERVER_RATE_PROBE
+#define UNI_NET_UDP_SERVER_RATE_PROBE              (8U)
+#endif
+
 /**
  * Return value indicating timeout/would-block for UDP operations.
  * Functions here return:
@@ -77,6 +126,61 @@ extern "C" {
  */
 typedef void (*uni_net_udp_server_recv_cb)(void* user, const uint8_t* payload, size_t length, const uni_net_udp_endpoint_t* from);
 
+/**
+ * Verdict returned by the IP-task receive callback.
+ */
+typedef enum {
+    UNI_NET_UDP_SERVER_RX_VERDICT_CONSUMED = 0, /* Datagram handled; the network buffer is released by the stack. */
+    UNI_NET_UDP_SERVER_RX_VERDICT_RETAIN   = 1, /* Keep the datagram queued on the socket for on_receive/recvfrom. */
+} uni_net_udp_server_rx_verdict_e;
+
+/**
+ * Receive callback for ultra-low-latency mode.
+ * Called directly from the FreeRTOS+TCP IP task with a pointer into the network buffer (zero-copy),
+ * before the datagram is queued on the socket.
+ *
+ * Contract:
+ *  - must not block: no mutexes, no queues with timeouts, no vTaskDelay;
+ *  - must run in bounded, short time: the whole stack (RX, TX, timers) is stalled meanwhile;
+ *  - payload is valid only for the duration of the callback unless RETAIN is returned, in which case the
+ *    datagram stays queued on the socket and is delivered later to on_receive or uni_net_udp_server_recvfrom();
+ *  - uni_net_udp_server_sendto() may be used to reply, it never blocks when called from the IP task.
+ *
+ * Parameters are identical to uni_net_udp_server_recv_cb.
+ */
+typedef uni_net_udp_server_rx_verdict_e (*uni_net_udp_server_recv_ip_cb)(void* user, const uint8_t* payload, size_t length, const uni_net_udp_endpoint_t* from);
+
+
+/**
+ * Additional port served by the same server task.
+ */
+typedef struct {
+    uint16_t                   port;             /* Local port (host byte order), bound on config.bind_addr. */
+    uni_net_udp_server_recv_cb on_receive;       /* Callback for datagrams received on this port. */
+    void*                      user;             /* User context pointer passed to callback. */
+} uni_net_udp_server_port_t;
+
+
+/**
+ * Per-source rate limiter slot (token bucket, tokens in 1/1000 of a datagram).
+ */
+typedef struct {
+    uni_net_udp_endpoint_t     peer;
+    uint32_t                   tokens;
+    TickType_t                 last_refill;
+    TickType_t                 last_seen;
+    uint32_t                   drops;            /* Datagrams dropped for this source since the slot was claimed. */
+    bool                       used;
+} uni_net_udp_server_rate_entry_t;
+
+/**
+ * Rate-limited source as reported by uni_net_udp_server_get_rate_limited().
+ */
+typedef struct {
+    uni_net_udp_endpoint_t     peer;
+    uint32_t                   drops;
+} uni_net_udp_server_rate_source_t;
+
 
 //
 // Configuration, State, Context
@@ -96,17 +200,70 @@ typedef struct {
     void*                      user;             /* User context pointer passed to callback. */
     UBaseType_t                task_priority;    /* Task priority for the server task. */
     uint32_t                   task_stack_words; /* Task stack size in words. */
+
+    // Ultra-low-latency mode
+    uni_net_udp_server_recv_ip_cb on_receive_ip;  /* Optional callback executed on the IP task, see uni_net_udp_server_recv_ip_cb. */
+
+    // Worker pool mode
+    uint32_t                   rx_workers;       /* 0: on_receive runs on the server task; 1..UNI_NET_UDP_SERVER_RX_WORKERS_MAX: on worker tasks. */
+    uint32_t                   rx_ring_depth;    /* Per-worker ring depth in datagrams (rounded up to a power of two), 0 for default. */
+
+    // Multi-port mode
+    uni_net_udp_server_port_t  ports[UNI_NET_UDP_SERVER_PORTS_MAX]; /* Additional ports served by this task. */
+    uint32_t                   ports_count;      /* Number of valid entries in ports. */
+
+    // Flood protection
+    uint32_t                   rate_limit_pps;   /* Per-source sustained rate in datagrams per second, 0 disables limiting. */
+    uint32_t                   rate_limit_burst; /* Per-source bucket size in datagrams, 0 for rate_limit_pps. */
+
+    // Adaptive receive batching, 0 selects the default bound
+    uint32_t                   rx_batch_min;     /* Smallest batch depth, default 1. */
+    uint32_t                   rx_batch_max;     /* Largest batch depth, default and limit UNI_NET_UDP_SERVER_RX_BATCH_DEPTH. */
+    uint32_t                   rx_burst_min;     /* Smallest burst budget, default rx_batch_max. */
+    uint32_t                   rx_burst_max;     /* Largest burst budget, default UNI_NET_UDP_SERVER_RX_BURST_BUDGET. */
 } uni_net_udp_server_config_t;
 
+typedef struct {
+    TaskHandle_t                task;
+    struct uni_net_udp_ring_s*  ring;
+    void*                       owner;
+    volatile bool               stop_requested;
+} uni_net_udp_server_worker_t;
+
+typedef struct {
+    uint32_t             depth;           /* Datagrams currently queued across all worker rings. */
+    uint32_t             high_water;      /* Highest depth observed on any single ring. */
+    uint64_t             overflow_total;  /* Datagrams dropped because the target ring was full. */
+} uni_net_udp_server_ring_stats_t;
+
+typedef struct {
+    uint32_t             batch_depth;     /* Datagrams per receive batch */
+    uint32_t             burst_budget;    /* Datagrams per wakeup before other sockets get their turn */
+} uni_net_udp_server_rx_tuning_t;
+
 typedef struct {
     bool                 initialized;
     Socket_t             socket;
     SemaphoreHandle_t    lock;
     TaskHandle_t         task;
+    SemaphoreHandle_t    exited;          /* Given by the server and worker tasks on exit */
     volatile bool        stop_requested;
-    uint64_t             rx_packets_total;
-    uint64_t             rx_drop_total;
     uint32_t             rx_queue_packets;
+    struct uni_net_udp_stats_s* stats;
+
+    uni_net_udp_server_worker_t workers[UNI_NET_UDP_SERVER_RX_WORKERS_MAX];
+    uint32_t             workers_count;
+
+    Socket_t             port_sockets[UNI_NET_UDP_SERVER_PORTS_MAX];
+    SocketSet_t          socket_set;
+    SocketSet_t          sync_set;        /* Waits for the primary socket in synchronous receive mode */
+    SemaphoreHandle_t    sync_lock;       /* Serializes synchronous receivers sharing sync_set */
+
+    uni_net_udp_server_rate_entry_t rate_table[UNI_NET_UDP_SERVER_RATE_SLOTS];
+
+    uni_net_udp_server_rx_tuning_t rx_tuning[UNI_NET_UDP_SERVER_PORTS_MAX + 1U]; /* Adapted per port, index 0 is bind_port */
+
+    uni_net_udp_mcast_set_t mcast;        /* Joined multicast groups */
 } uni_net_udp_server_state_t;
 
 typedef struct {
@@ -128,14 +285,34 @@ typedef struct {
  * outside a task.
  *
  * Behavior inside the task:
- *  - Waits for network up using FreeRTOS_IsNetworkUp() before binding.
+ *  - Waits for network up before binding: woken by uni_net_udp_server_network_event(), falls back to
+ *    polling FreeRTOS_IsNetworkUp() every UNI_NET_UDP_SERVER_IFACE_TIME_MS.
  *  - Creates a datagram socket (AF_INET/SOCK_DGRAM/IPPROTO_UDP).
  *  - Applies RCVTIMEO/SNDTIMEO using pdMS_TO_TICKS.
  *  - Binds to the requested local port/address (IPv4).
+ *  - If on_receive_ip is non-NULL, it is installed as FREERTOS_SO_UDP_RECV_HANDLER
+ *    and sees every datagram first, on the IP task.
  *  - If config.use_task is true and on_receive is non-NULL, the task blocks in
  *    FreeRTOS_recvfrom() and invokes the callback for each datagram.
- *  - Otherwise, the task idles while keeping the socket available for
- *    synchronous APIs (e.g., uni_net_udp_server_recvfrom()) from other tasks.
+ *  - If rx_workers is non-zero, the task only drains the socket: zero-copy payloads are pushed
+ *    into per-worker lock-free rings selected by a hash of the source endpoint (datagrams from one
+ *    peer are always handled by the same worker, in order) and on_receive runs on the worker tasks.
+ *    Datagrams that do not fit into the ring are released immediately and counted as drops.
+ *  - If ports_count is non-zero, every entry of ports is bound to its own socket and the task waits
+ *    on all sockets at once with FreeRTOS_select(), burst-draining each readable socket into its own
+ *    callback. One task and one stack serve all ports; on_receive_ip applies to bind_port only.
+ *  - If rate_limit_pps is non-zero, every datagram is charged to a per-source token bucket before
+ *    it reaches on_receive_ip, on_receive or a worker ring. Over-budget datagrams are released
+ *    immediately and counted both per source and in the drop counter. Datagrams read with the
+ *    synchronous APIs are not limited.
+ *  - Batch depth and burst budget adapt per port between the configured bounds: both double while a
+ *    socket keeps refilling faster than one burst drains it (fewer wakeups under load) and halve down
+ *    to the minimum when a wakeup finds a single datagram (lowest latency for sparse traffic).
+ *  - Otherwise, the task blocks on its notification without waking up while keeping the socket
+ *    available for synchronous APIs (e.g., uni_net_udp_server_recvfrom()) from other tasks.
+ *  - With UNI_NET_UDP_RX_TIMESTAMPS every server socket gets a receive handler that stamps datagrams on
+ *    the IP task; callbacks read the stamp with uni_net_udp_payload_rx_time_us() and the delay until
+ *    on_receive runs is collected in the queue_delay_us histogram of uni_net_udp_server_get_stats().
  *
  * Note:
  *  - Call uni_net_udp_server_is_inited() to check when initialization has
@@ -160,17 +337,27 @@ bool uni_net_udp_server_start(uni_net_udp_server_context_t* ctx, const uni_net_u
 bool uni_net_udp_server_is_inited(const uni_net_udp_server_context_t* ctx);
 
 /**
- * Stop the UDP server: request task termination if running, unblock any pending recvfrom,
- * wait for the task to exit, then close the socket and release synchronization primitives.
+ * Stop the UDP server: request task termination if running, wake the task with a notification and
+ * FreeRTOS_SignalSocket() (lowering RCVTIMEO when ipconfigSUPPORT_SIGNALS is disabled), block until
+ * the task and workers signal their exit, then close the socket and release synchronization primitives.
  *
  * Returns:
  *  - true on success; false on invalid argument or not initialized.
  */
 bool uni_net_udp_server_stop(uni_net_udp_server_context_t* ctx);
 
+/**
+ * Forward FreeRTOS+TCP network events; call from vApplicationIPNetworkEventHook_Multi(). On eNetworkUp,
+ * server tasks waiting for the network start binding immediately instead of at their next poll.
+ */
+void uni_net_udp_server_network_event(eIPCallbackEvent_t event);
+
 /**
  * Synchronous receive API: receive one UDP datagram with a specified timeout override.
  * This API must not be used concurrently with the task-driven mode (i.e., when a server task is running).
+ * The timeout is applied per call by waiting on the socket with FreeRTOS_select(), the socket options
+ * are not touched. Concurrent synchronous callers are served one at a time, time spent waiting for
+ * another caller counts against timeout_ms.
  *
  * Parameters:
  *  - ctx: Server context (must be started and not running a receive task).
@@ -189,6 +376,18 @@ bool uni_net_udp_server_stop(uni_net_udp_server_context_t* ctx);
  */
 int32_t uni_net_udp_server_recvfrom(uni_net_udp_server_context_t* ctx, uint8_t* buf, size_t buf_size, uni_net_udp_endpoint_t* out_from, uint32_t timeout_ms);
 
+/**
+ * Synchronous batch receive: wait up to timeout_ms for the first datagram, then copy every datagram
+ * already queued on the socket into items without further waiting, up to count.
+ * Same restrictions as uni_net_udp_server_recvfrom().
+ *
+ * Returns:
+ *  - > 0 : number of items filled (length/from set for items[0..n-1])
+ *  -   0 : timeout
+ *  - < 0 : negative FreeRTOS+TCP-style error
+ */
+int32_t uni_net_udp_server_recv_batch(uni_net_udp_server_context_t* ctx, uni_net_udp_rx_item_t* items, size_t count, uint32_t timeout_ms);
+
 /**
  * Send one UDP datagram to a specific endpoint. Can be called from the server's callback or other tasks.
  * Guarantees single-datagram semantics; partial sends are treated as error.
@@ -200,6 +399,18 @@ int32_t uni_net_udp_server_recvfrom(uni_net_udp_server_context_t* ctx, uint8_t*
  */
 int32_t uni_net_udp_server_sendto(uni_net_udp_server_context_t* ctx, const uint8_t* buf, size_t len, const uni_net_udp_endpoint_t* to);
 
+/**
+ * Send a batch of zero-copy datagrams, see uni_net_udp_client_sendto_batch() for buffer ownership and
+ * result semantics. Can be called from the server's callback or other tasks.
+ */
+int32_t uni_net_udp_server_sendto_batch(uni_net_udp_server_context_t* ctx, uni_net_udp_tx_item_t* items, size_t count);
+
+/**
+ * Send a payload larger than one datagram, see uni_net_udp_client_sendto_large(). Can be called from the
+ * server's callback or other tasks.
+ */
+int32_t uni_net_udp_server_sendto_large(uni_net_udp_server_context_t* ctx, const uint8_t* buf, size_t len, const uni_net_udp_endpoint_t* to);
+
 /**
  * Configure send/receive timeouts (in milliseconds) for the server socket at runtime.
  * Thread-safe w.r.t. sendto; the server's internal task continues using the updated timeouts.
@@ -217,10 +428,58 @@ bool uni_net_udp_server_get_timeouts(const uni_net_udp_server_context_t* ctx, ui
 uint32_t uni_net_udp_server_get_rx_queue_packets(const uni_net_udp_server_context_t* ctx);
 
 /**
- * Get accumulated receive drop counter for this server context.
+ * Get accumulated receive drop counter (all reasons) for this server context.
  */
 uint64_t uni_net_udp_server_get_rx_drop_count(const uni_net_udp_server_context_t* ctx);
 
+/**
+ * Get a consistent statistics snapshot: traffic counters, drops by reason, receive batch-size and
+ * callback time histograms, socket queue high-water. Safe to call from any task while the server runs.
+ * Returns false if concurrent updates kept the snapshot from being consistent; retry later.
+ */
+bool uni_net_udp_server_get_stats(const uni_net_udp_server_context_t* ctx, uni_net_udp_stats_t* out_stats);
+
+/**
+ * Get the adaptive receive batch depth and burst budget of one port; the stats snapshot only carries the
+ * values of the port adapted last.
+ * @param port_index 0 for bind_port, 1..ports_count for the extra ports in config order
+ * @return false for an unknown port
+ */
+bool uni_net_udp_server_get_rx_tuning(const uni_net_udp_server_context_t* ctx, uint32_t port_index, uni_net_udp_server_rx_tuning_t* out_tuning);
+
+/**
+ * Get number of datagrams dropped by the per-source rate limiter.
+ */
+uint64_t uni_net_udp_server_get_rate_limited_count(const uni_net_udp_server_context_t* ctx);
+
+/**
+ * Copy sources currently tracked by the rate limiter that had at least one datagram dropped.
+ * The table is updated by the server task concurrently, so the result is a best-effort view.
+ *
+ * Returns:
+ *  - number of entries written to out_sources (at most capacity)
+ */
+size_t uni_net_udp_server_get_rate_limited(const uni_net_udp_server_context_t* ctx, uni_net_udp_server_rate_source_t* out_sources, size_t capacity);
+
+/**
+ * Get worker ring metrics (all zero when worker pool mode is disabled).
+ */
+bool uni_net_udp_server_get_ring_stats(const uni_net_udp_server_context_t* ctx, uni_net_udp_server_ring_stats_t* out_stats);
+
+/**
+ * Join an IPv4 multicast group (network byte order); datagrams sent to the group and any of the server
+ * ports are delivered like unicast ones. See uni_net_udp_client_join_group() for IGMP handling. Groups
+ * still joined are left by uni_net_udp_server_stop(). Thread-safe; requires a started server.
+ *
+ * To fan out to all members, pass the group as destination to uni_net_udp_server_sendto() and friends.
+ */
+bool uni_net_udp_server_join_group(uni_net_udp_server_context_t* ctx, uint32_t group);
+
+/**
+ * Leave a multicast group joined with uni_net_udp_server_join_group(). Thread-safe.
+ */
+bool uni_net_udp_server_leave_group(uni_net_udp_server_context_t* ctx, uint32_t group);
+
 /**
  * Best-effort control to disable UDP checksum if supported by the stack build. If not supported,
  * this call is a no-op and returns true.
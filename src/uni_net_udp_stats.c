@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: MIT
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdbool.h>
+#include <string.h>
+
+// FreeRTOS
+#include <FreeRTOS.h>
+#include <task.h>
+
+// Uni.Net
+#include "uni_net_udp_stats.h"
+
+
+
+//
+// Defines
+//
+
+#define UNI_NET_UDP_STATS_SNAPSHOT_ATTEMPTS (4U)
+
+
+
+//
+// Private
+//
+
+static uint32_t _log2_bucket(uint32_t value, uint32_t buckets) {
+    uint32_t bucket = 0U;
+    while ((value > 1U) && (bucket < (buckets - 1U))) {
+        value >>= 1U;
+        bucket++;
+    }
+    return bucket;
+}
+
+static inline void _counter_add(uni_net_udp_stats_counter_t* counter, uint64_t amount) {
+    atomic_fetch_add_explicit(counter, amount, memory_order_relaxed);
+}
+
+static inline uint64_t _counter_get(const uni_net_udp_stats_counter_t* counter) {
+    return (uint64_t)atomic_load_explicit((uni_net_udp_stats_counter_t*)counter, memory_order_relaxed);
+}
+
+static inline void _max_update(atomic_uint_least32_t* target, uint32_t value) {
+    uint32_t current = atomic_load_explicit(target, memory_order_relaxed);
+    while (value > current
+        && !atomic_compare_exchange_weak_explicit(target, &current, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/*
+ * Writers may run concurrently from several tasks, so a single odd/even sequence cannot tell whether one
+ * is still in progress. Started and finished writes are counted in separate words instead, a write is
+ * pending while they differ; both wrap independently, only equality is compared.
+ */
+static inline void _write_begin(uni_net_udp_stats_block_t* stats) {
+    atomic_fetch_add_explicit(&stats->writes_begun, 1U, memory_order_relaxed);
+    // Counter updates must not become visible before the write is marked as started
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void _write_end(uni_net_udp_stats_block_t* stats) {
+    atomic_fetch_add_explicit(&stats->writes_done, 1U, memory_order_release);
+}
+
+
+
+//
+// Public
+//
+
+uni_net_udp_stats_block_t* uni_net_udp_stats_create(void) {
+    uni_net_udp_stats_block_t* stats = pvPortMalloc(sizeof(*stats));
+    if (stats != nullptr) {
+        memset(stats, 0, sizeof(*stats));
+    }
+    return stats;
+}
+
+void uni_net_udp_stats_delete(uni_net_udp_stats_block_t* stats) {
+    if (stats != nullptr) {
+        vPortFree(stats);
+    }
+}
+
+void uni_net_udp_stats_add_rx(uni_net_udp_stats_block_t* stats, uint32_t packets, size_t bytes) {
+    if (stats != nullptr && packets > 0U) {
+        _write_begin(stats);
+        _counter_add(&stats->rx_packets, packets);
+        _counter_add(&stats->rx_bytes, bytes);
+        _write_end(stats);
+    }
+}
+
+void uni_net_udp_stats_add_tx(uni_net_udp_stats_block_t* stats, uint32_t packets, size_t bytes) {
+    if (stats != nullptr && packets > 0U) {
+        _write_begin(stats);
+        _counter_add(&stats->tx_packets, packets);
+        _counter_add(&stats->tx_bytes, bytes);
+        _write_end(stats);
+    }
+}
+
+void uni_net_udp_stats_add_tx_error(uni_net_udp_stats_block_t* stats) {
+    if (stats != nullptr) {
+        _write_begin(stats);
+        _counter_add(&stats->tx_errors, 1U);
+        _write_end(stats);
+    }
+}
+
+void uni_net_udp_stats_add_tx_result(uni_net_udp_stats_block_t* stats, int32_t rv) {
+    if (rv > 0) {
+        uni_net_udp_stats_add_tx(stats, 1U, (size_t)rv);
+    } else if (rv < 0) {
+        uni_net_udp_stats_add_tx_error(stats);
+    }
+}
+
+void uni_net_udp_stats_add_drop(uni_net_udp_stats_block_t* stats, uni_net_udp_drop_reason_e reason, uint32_t amount) {
+    if (stats != nullptr && reason < UNI_NET_UDP_DROP_REASON_COUNT && amount > 0U) {
+        _write_begin(stats);
+        _counter_add(&stats->drops[reason], amount);
+        _write_end(stats);
+    }
+}
+
+void uni_net_udp_stats_add_batch(uni_net_udp_stats_block_t* stats, uint32_t size) {
+    if (stats != nullptr && size > 0U) {
+        _write_begin(stats);
+        _counter_add(&stats->batch_hist[_log2_bucket(size, UNI_NET_UDP_STATS_BATCH_BUCKETS)], 1U);
+        _write_end(stats);
+    }
+}
+
+void uni_net_udp_stats_add_callback_time(uni_net_udp_stats_block_t* stats, uint32_t time_us) {
+    if (stats != nullptr) {
+        _write_begin(stats);
+        _counter_add(&stats->callback_us_hist[_log2_bucket(time_us, UNI_NET_UDP_STATS_TIME_BUCKETS)], 1U);
+        _max_update(&stats->callback_us_max, time_us);
+        _write_end(stats);
+    }
+}
+
+void uni_net_udp_stats_add_queue_delay(uni_net_udp_stats_block_t* stats, uint32_t delay_us) {
+    if (stats != nullptr) {
+        _write_begin(stats);
+        _counter_add(&stats->queue_delay_us_hist[_log2_bucket(delay_us, UNI_NET_UDP_STATS_TIME_BUCKETS)], 1U);
+        _max_update(&stats->queue_delay_us_max, delay_us);
+        _write_end(stats);
+    }
+}
+
+void uni_net_udp_stats_update_queue(uni_net_udp_stats_block_t* stats, uint32_t depth) {
+    if (stats != nullptr) {
+        _write_begin(stats);
+        _max_update(&stats->queue_high_water, depth);
+        _write_end(stats);
+    }
+}
+
+void uni_net_udp_stats_set_rx_tuning(uni_net_udp_stats_block_t* stats, uint32_t batch_depth, uint32_t burst_budget) {
+    if (stats != nullptr) {
+        _write_begin(stats);
+        atomic_store_explicit(&stats->rx_batch_depth, batch_depth, memory_order_relaxed);
+        atomic_store_explicit(&stats->rx_burst_budget, burst_budget, memory_order_relaxed);
+        _write_end(stats);
+    }
+}
+
+bool uni_net_udp_stats_snapshot(const uni_net_udp_stats_block_t* stats, uni_net_udp_stats_t* out) {
+    if (out == nullptr) {
+        return false;
+    }
+
+    if (stats == nullptr) {
+        memset(out, 0, sizeof(*out));
+        return true;
+    }
+
+    // Copied aside, a failed snapshot leaves out untouched
+    uni_net_udp_stats_t copy;
+
+    uni_net_udp_stats_block_t* block = (uni_net_udp_stats_block_t*)stats;
+    for (uint32_t attempt = 0; attempt < UNI_NET_UDP_STATS_SNAPSHOT_ATTEMPTS; attempt++) {
+        // Begun is read first: a write finishing in between makes done run ahead and the attempt retries
+        const unsigned begun_before = atomic_load_explicit(&block->writes_begun, memory_order_acquire);
+        const unsigned done_before = atomic_load_explicit(&block->writes_done, memory_order_acquire);
+        if (begun_before != done_before) {
+            taskYIELD();
+            continue;
+        }
+
+        memset(&copy, 0, sizeof(copy));
+
+        copy.rx_packets = _counter_get(&block->rx_packets);
+        copy.rx_bytes = _counter_get(&block->rx_bytes);
+        copy.tx_packets = _counter_get(&block->tx_packets);
+        copy.tx_bytes = _counter_get(&block->tx_bytes);
+        copy.tx_errors = _counter_get(&block->tx_errors);
+        for (uint32_t i = 0; i < UNI_NET_UDP_DROP_REASON_COUNT; i++) {
+            copy.drops[i] = _counter_get(&block->drops[i]);
+        }
+        for (uint32_t i = 0; i < UNI_NET_UDP_STATS_BATCH_BUCKETS; i++) {
+            copy.batch_hist[i] = _counter_get(&block->batch_hist[i]);
+        }
+        for (uint32_t i = 0; i < UNI_NET_UDP_STATS_TIME_BUCKETS; i++) {
+            copy.callback_us_hist[i] = _counter_get(&block->callback_us_hist[i]);
+        }
+        copy.callback_us_max = atomic_load_explicit(&block->callback_us_max, memory_order_relaxed);
+        for (uint32_t i = 0; i < UNI_NET_UDP_STATS_TIME_BUCKETS; i++) {
+            copy.queue_delay_us_hist[i] = _counter_get(&block->queue_delay_us_hist[i]);
+        }
+        copy.queue_delay_us_max = atomic_load_explicit(&block->queue_delay_us_max, memory_order_relaxed);
+        copy.queue_high_water = atomic_load_explicit(&block->queue_high_water, memory_order_relaxed);
+        copy.rx_batch_depth = atomic_load_explicit(&block->rx_batch_depth, memory_order_relaxed);
+        copy.rx_burst_budget = atomic_load_explicit(&block->rx_burst_budget, memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&block->writes_begun, memory_order_relaxed) == begun_before) {
+            *out = copy;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint64_t uni_net_udp_stats_drops_total(const uni_net_udp_stats_t* snapshot) {
+    uint64_t total = 0U;
+    if (snapshot != nullptr) {
+        for (uint32_t i = 0; i < UNI_NET_UDP_DROP_REASON_COUNT; i++) {
+            total += snapshot->drops[i];
+        }
+    }
+    return total;
+}
+
+uint64_t uni_net_udp_stats_get_drops(const uni_net_udp_stats_block_t* stats, uni_net_udp_drop_reason_e reason) {
+    uint64_t total = 0U;
+    if (stats != nullptr) {
+        for (uint32_t i = 0; i < UNI_NET_UDP_DROP_REASON_COUNT; i++) {
+            if (reason == UNI_NET_UDP_DROP_REASON_COUNT || (uint32_t)reason == i) {
+                total += _counter_get(&stats->drops[i]);
+            }
+        }
+    }
+    return total;
+}
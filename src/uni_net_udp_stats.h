@@ -0,0 +1,111 @@
+#pragma once
+
+/*
+ * Lock-free UDP statistics block shared by the UDP client and server (internal to Uni.NET).
+ *
+ * Writers from any task update counters with relaxed atomics between counting a write as started and
+ * as finished; uni_net_udp_stats_snapshot() retries the copy while a write is in progress or a new one
+ * started underneath it.
+ */
+
+//
+// Includes
+//
+
+// stdlib
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Uni.Net
+#include "uni_net_udp_client.h"
+
+
+
+//
+// Typedefs
+//
+
+#if ATOMIC_LLONG_LOCK_FREE == 2
+typedef atomic_ullong uni_net_udp_stats_counter_t;
+#else
+typedef atomic_ulong  uni_net_udp_stats_counter_t;
+#endif
+
+typedef struct uni_net_udp_stats_s {
+    atomic_uint                 writes_begun;
+    atomic_uint                 writes_done;
+    uni_net_udp_stats_counter_t rx_packets;
+    uni_net_udp_stats_counter_t rx_bytes;
+    uni_net_udp_stats_counter_t tx_packets;
+    uni_net_udp_stats_counter_t tx_bytes;
+    uni_net_udp_stats_counter_t tx_errors;
+    uni_net_udp_stats_counter_t drops[UNI_NET_UDP_DROP_REASON_COUNT];
+    uni_net_udp_stats_counter_t batch_hist[UNI_NET_UDP_STATS_BATCH_BUCKETS];
+    uni_net_udp_stats_counter_t callback_us_hist[UNI_NET_UDP_STATS_TIME_BUCKETS];
+    atomic_uint_least32_t       callback_us_max;
+    uni_net_udp_stats_counter_t queue_delay_us_hist[UNI_NET_UDP_STATS_TIME_BUCKETS];
+    atomic_uint_least32_t       queue_delay_us_max;
+    atomic_uint_least32_t       queue_high_water;
+    atomic_uint_least32_t       rx_batch_depth;
+    atomic_uint_least32_t       rx_burst_budget;
+} uni_net_udp_stats_block_t;
+
+
+
+//
+// Functions
+//
+
+/**
+ * Allocate a zeroed statistics block.
+ * @return block pointer or NULL on allocation failure
+ */
+uni_net_udp_stats_block_t* uni_net_udp_stats_create(void);
+
+void uni_net_udp_stats_delete(uni_net_udp_stats_block_t* stats);
+
+/*
+ * Updates below are no-ops for a NULL block.
+ */
+
+void uni_net_udp_stats_add_rx(uni_net_udp_stats_block_t* stats, uint32_t packets, size_t bytes);
+
+void uni_net_udp_stats_add_tx(uni_net_udp_stats_block_t* stats, uint32_t packets, size_t bytes);
+
+void uni_net_udp_stats_add_tx_error(uni_net_udp_stats_block_t* stats);
+
+/**
+ * Account the result of one send: bytes on success, an error when negative, nothing on timeout.
+ */
+void uni_net_udp_stats_add_tx_result(uni_net_udp_stats_block_t* stats, int32_t rv);
+
+void uni_net_udp_stats_add_drop(uni_net_udp_stats_block_t* stats, uni_net_udp_drop_reason_e reason, uint32_t amount);
+
+void uni_net_udp_stats_add_batch(uni_net_udp_stats_block_t* stats, uint32_t size);
+
+void uni_net_udp_stats_add_callback_time(uni_net_udp_stats_block_t* stats, uint32_t time_us);
+
+void uni_net_udp_stats_add_queue_delay(uni_net_udp_stats_block_t* stats, uint32_t delay_us);
+
+void uni_net_udp_stats_update_queue(uni_net_udp_stats_block_t* stats, uint32_t depth);
+
+void uni_net_udp_stats_set_rx_tuning(uni_net_udp_stats_block_t* stats, uint32_t batch_depth, uint32_t burst_budget);
+
+/**
+ * Copy the block into a plain snapshot. Output is zeroed for a NULL block.
+ * @return false if writers kept the block busy for every attempt, out is left untouched then
+ */
+bool uni_net_udp_stats_snapshot(const uni_net_udp_stats_block_t* stats, uni_net_udp_stats_t* out);
+
+/**
+ * Sum of drops over all reasons in a snapshot.
+ */
+uint64_t uni_net_udp_stats_drops_total(const uni_net_udp_stats_t* snapshot);
+
+/**
+ * Drops of one reason read straight from the block, a single counter needs no snapshot.
+ * @param reason drop reason, UNI_NET_UDP_DROP_REASON_COUNT for the sum over all reasons
+ */
+uint64_t uni_net_udp_stats_get_drops(const uni_net_udp_stats_block_t* stats, uni_net_udp_drop_reason_e reason);